@@ -0,0 +1,74 @@
+/* dzf-allocator.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! @file dzf-allocator.h
+ *
+ * @brief Allocator Interface.
+ *
+ * Containers get their buckets from libc through 'dzf_realloc' unless
+ * an allocator is given to their '*_with_allocator' initializer.
+ * An allocator is a set of callbacks with a user context pointer, so that
+ * hot containers can be routed to arenas, pools or hugepages.
+ *
+ * Every callback receives the size of the block in byte unit, and must
+ * return NULL only on failure, which is fatal like dzf_realloc.
+ *
+ * Define 'DZF_DEFAULT_ALLOCATOR' to a pointer to dzf_allocator_t before
+ * including any of dzf headers to change the allocator of containers
+ * initialized without one in the translation unit. They keep it wherever
+ * else they are grown or freed.
+ *
+ * \b Examples
+ * @code{.c}
+ *   static void *my_alloc(void *ctx, size_t size);
+ *   static void *my_realloc(void *ctx, void *ptr,
+ *                           size_t old_size, size_t new_size);
+ *   static void my_free(void *ctx, void *ptr, size_t size);
+ *
+ *   static const dzf_allocator_t my_allocator = {
+ *       my_alloc, my_realloc, my_free, &my_ctx
+ *   };
+ *
+ *   dzf_vec_new_with_allocator(&vec, sizeof(int), 64, &my_allocator);
+ * @endcode
+ */
+
+#ifndef DZF_ALLOCATOR_H
+#define DZF_ALLOCATOR_H
+
+#include "dzf-util.h"
+
+typedef struct dzf_allocator {
+    void *(*alloc)(void *ctx, size_t size);
+    void *(*realloc)(void *ctx, void *ptr, size_t old_size, size_t new_size);
+    void (*free)(void *ctx, void *ptr, size_t size);
+    void *ctx;
+} dzf_allocator_t;
+
+/* NULL means libc */
+#if !defined(DZF_DEFAULT_ALLOCATOR)
+#   define DZF_DEFAULT_ALLOCATOR ((const dzf_allocator_t *)NULL)
+#endif
+
+#endif /* DZF_ALLOCATOR_H */
@@ -0,0 +1,197 @@
+/* dzf-arena-priv.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef DZF_ARENA_PRIV_H
+#define DZF_ARENA_PRIV_H
+
+#if !defined (DZF_ARENA_USE_AS_PRIVATE)
+#   error "Only <dzf/dzf-arena.h> can be included directly!"
+#endif
+
+#include "dzf-util.h"
+#include "dzf-allocator.h"
+
+#define DZF_ARENA_CHUNK_SIZE  (64 * 1024) /* default chunk size in byte */
+#define DZF_ARENA_ALIGN       16          /* alignment of every block */
+
+/* -- Type Definition -- */
+typedef struct __dzf_arena_chunk {
+    struct __dzf_arena_chunk *next;
+    size_t size;    /* bytes for blocks */
+    size_t used;
+} __dzf_arena_chunk_t;
+
+typedef struct dzf_arena {
+    dzf_allocator_t allocator;  /* 'ctx' points back to the arena */
+    __dzf_arena_chunk_t *first;
+    __dzf_arena_chunk_t *cur;   /* chunks after it are free to reuse */
+    void *last;                 /* the latest block, grows in place */
+    size_t chunk_size;
+} dzf_arena_t;
+
+
+/* -- Private APIs -- */
+DZF_PRIVATE
+static inline size_t
+__dzf_arena_round_up(size_t size)
+{
+    return (size + (DZF_ARENA_ALIGN - 1)) & ~(size_t)(DZF_ARENA_ALIGN - 1);
+}
+
+
+DZF_PRIVATE
+static inline char *
+__dzf_arena_chunk_data(__dzf_arena_chunk_t *chunk)
+{
+    return (char *)chunk + __dzf_arena_round_up(sizeof(*chunk));
+}
+
+
+DZF_PRIVATE
+static inline __dzf_arena_chunk_t *
+__dzf_arena_chunk_new(size_t size)
+{
+    __dzf_arena_chunk_t *chunk;
+
+    chunk = dzf_malloc(__dzf_arena_round_up(sizeof(*chunk)) + size);
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+
+    return chunk;
+}
+
+
+DZF_PRIVATE
+static inline void *
+__dzf_arena_bump(dzf_arena_t *arena,
+                 __dzf_arena_chunk_t *chunk, size_t size)
+{
+    void *ptr = __dzf_arena_chunk_data(chunk) + chunk->used;
+
+    chunk->used += size;
+    arena->cur = chunk;
+    arena->last = ptr;
+
+    return ptr;
+}
+
+
+DZF_PRIVATE
+static inline void *
+__dzf_arena_alloc(dzf_arena_t *arena,
+                  size_t size)
+{
+    __dzf_arena_chunk_t *cur = arena->cur;
+    __dzf_arena_chunk_t *chunk;
+
+    size = __dzf_arena_round_up(size);
+
+    if (cur && cur->size - cur->used >= size)
+        return __dzf_arena_bump(arena, cur, size);
+
+    /* the next one is left from before reset, reuse it if it fits */
+    if (cur && cur->next && cur->next->size >= size) {
+        cur->next->used = 0;
+        return __dzf_arena_bump(arena, cur->next, size);
+    }
+
+    chunk = __dzf_arena_chunk_new(size > arena->chunk_size
+                                  ? size : arena->chunk_size);
+    if (cur) {
+        chunk->next = cur->next;
+        cur->next = chunk;
+    } else {
+        chunk->next = arena->first;
+        arena->first = chunk;
+    }
+
+    return __dzf_arena_bump(arena, chunk, size);
+}
+
+
+DZF_PRIVATE
+static inline void *
+__dzf_arena_realloc(dzf_arena_t *arena, void *ptr,
+                    size_t old_size, size_t new_size)
+{
+    __dzf_arena_chunk_t *cur = arena->cur;
+    void *newm;
+
+    old_size = __dzf_arena_round_up(old_size);
+    new_size = __dzf_arena_round_up(new_size);
+
+    /* the latest block can grow or shrink in place */
+    if (ptr && ptr == arena->last &&
+        cur->size - cur->used + old_size >= new_size) {
+        cur->used = cur->used - old_size + new_size;
+        return ptr;
+    }
+
+    newm = __dzf_arena_alloc(arena, new_size);
+    if (ptr)
+        memcpy(newm, ptr, old_size < new_size ? old_size : new_size);
+
+    return newm;
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_arena_free(dzf_arena_t *arena, void *ptr,
+                 size_t size)
+{
+    /* only the latest block is given back, the rest waits for reset */
+    if (ptr && ptr == arena->last) {
+        arena->cur->used -= __dzf_arena_round_up(size);
+        arena->last = NULL;
+    }
+}
+
+
+DZF_PRIVATE
+static inline void *
+__dzf_arena_alloc_cb(void *ctx, size_t size)
+{
+    return __dzf_arena_alloc(ctx, size);
+}
+
+
+DZF_PRIVATE
+static inline void *
+__dzf_arena_realloc_cb(void *ctx, void *ptr,
+                       size_t old_size, size_t new_size)
+{
+    return __dzf_arena_realloc(ctx, ptr, old_size, new_size);
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_arena_free_cb(void *ctx, void *ptr, size_t size)
+{
+    __dzf_arena_free(ctx, ptr, size);
+}
+
+#endif /* DZF_ARENA_PRIV_H */
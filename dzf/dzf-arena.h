@@ -0,0 +1,166 @@
+/* dzf-arena.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! @file dzf-arena.h
+ *
+ * @brief Arena (Region) Allocator.
+ *
+ * dzf_arena_t hands out memory by bumping a pointer in chunks that are
+ * 'DZF_ARENA_CHUNK_SIZE' bytes by default, and gets it all back at once
+ * by 'dzf_arena_reset' in O(1). Chunks are kept and reused after reset,
+ * so that a steady workload stops calling malloc at all.
+ *
+ * Containers are built against an arena by passing 'dzf_arena_allocator'
+ * to their '*_with_allocator' initializer. Then freeing their data is
+ * a no-op, and tearing them down is just a reset of the arena.
+ *
+ * Note that every container built against the arena must not be used
+ * after reset, and that dzf_arena_t is not thread-safe.
+ *
+ * \b Examples
+ * @code{.c}
+ *   dzf_arena_t arena;
+ *   dzf_vec_t(int) vec;
+ *
+ *   dzf_arena_init(&arena, 0);
+ *   dzf_vec_new_with_allocator(&vec, sizeof(int), 8,
+ *                              dzf_arena_allocator(&arena));
+ *   ...
+ *   dzf_arena_reset(&arena);
+ *   ...
+ *   dzf_arena_release(&arena);
+ * @endcode
+ */
+
+#ifndef DZF_ARENA_H
+#define DZF_ARENA_H
+
+#define DZF_ARENA_USE_AS_PRIVATE
+#include "dzf-arena-priv.h"
+
+
+/*!
+ * Initialize a dzf_arena_t instance.
+ *
+ * No chunk is allocated until the first block is requested.
+ *
+ * @param arena: an instance of dzf_arena_t.
+ * @param chunk_size: size of each chunk in byte unit, 0 for default.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_arena_init(dzf_arena_t *arena,
+               size_t chunk_size)
+{
+    __die(arena);
+
+    arena->allocator.alloc = __dzf_arena_alloc_cb;
+    arena->allocator.realloc = __dzf_arena_realloc_cb;
+    arena->allocator.free = __dzf_arena_free_cb;
+    arena->allocator.ctx = arena;
+    arena->first = NULL;
+    arena->cur = NULL;
+    arena->last = NULL;
+    arena->chunk_size = chunk_size ? chunk_size : DZF_ARENA_CHUNK_SIZE;
+
+    return 0;
+}
+
+/*!
+ * Get the allocator of dzf_arena_t to build containers against it.
+ *
+ * @param arena: an instance of dzf_arena_t.
+ * @return an allocator valid as long as the arena is.
+ */
+DZF_PUBLIC
+static inline const dzf_allocator_t *
+dzf_arena_allocator(dzf_arena_t *arena)
+{
+    __die(arena);
+
+    return &arena->allocator;
+}
+
+/*!
+ * Allocate a block from dzf_arena_t.
+ *
+ * @param arena: an instance of dzf_arena_t.
+ * @param size: size of the block in byte unit.
+ * @return a block aligned to 'DZF_ARENA_ALIGN'.
+ */
+DZF_PUBLIC
+static inline void *
+dzf_arena_alloc(dzf_arena_t *arena,
+                size_t size)
+{
+    __die(arena);
+
+    return __dzf_arena_alloc(arena, size);
+}
+
+/*!
+ * Give every block back to dzf_arena_t at once, in O(1).
+ *
+ * The chunks are kept to be reused.
+ *
+ * @param arena: an instance of dzf_arena_t.
+ * @return none
+ */
+DZF_PUBLIC
+static inline void
+dzf_arena_reset(dzf_arena_t *arena)
+{
+    __die(arena);
+
+    if (arena->first)
+        arena->first->used = 0;
+    arena->cur = arena->first;
+    arena->last = NULL;
+}
+
+/*!
+ * Free every chunk of dzf_arena_t.
+ *
+ * @param arena: an instance of dzf_arena_t.
+ * @return none
+ */
+DZF_PUBLIC
+static inline void
+dzf_arena_release(dzf_arena_t *arena)
+{
+    __dzf_arena_chunk_t *chunk, *next;
+
+    __die(arena);
+
+    for (chunk = arena->first; chunk; chunk = next) {
+        next = chunk->next;
+        free(chunk);
+    }
+    arena->first = NULL;
+    arena->cur = NULL;
+    arena->last = NULL;
+}
+
+#endif /* DZF_ARENA_H */
@@ -30,25 +30,36 @@
 #endif
 
 #include "dzf-util.h"
+#include "dzf-allocator.h"
 
 typedef struct __dzf_base {
-    int length;
+    size_t length;
     size_t alloc_size;
     size_t elem_size;
+    unsigned int flags;
+    unsigned int grow_policy;
+    size_t grow_arg;
+    const dzf_allocator_t *allocator;
+    size_t align;               /* alignment of 'data', 0 for natural */
 } __dzf_base_t;
 
 #define DZF_GET_BASE(self) ((__dzf_base_t*)self)
 
+/* -- Flags -- */
+#define DZF_BASE_FLAG_GROWABLE    (1u << 0)  /* grow instead of dying on full */
+#define DZF_BASE_FLAG_AUTO_SHRINK (1u << 1)  /* shrink as elems are removed */
+#define DZF_BASE_FLAG_BORROWED    (1u << 2)  /* 'data' is not ours to free */
+
 DZF_PRIVATE
-static inline int
+static inline size_t
 __dzf_base_set_length(void *self,
-                      int length)
+                      size_t length)
 {
     return (DZF_GET_BASE(self)->length = length, length);
 }
 
 DZF_PRIVATE
-static inline int
+static inline size_t
 __dzf_base_get_length(void *self)
 {
     return DZF_GET_BASE(self)->length;
@@ -86,14 +97,241 @@ __dzf_base_get_elem_size(void *self)
     return DZF_GET_BASE(self)->elem_size;
 }
 
+DZF_PRIVATE
+static inline unsigned int
+__dzf_base_set_flags(void *self,
+                     unsigned int flags)
+{
+    return (DZF_GET_BASE(self)->flags = flags, flags);
+}
+
+DZF_PRIVATE
+static inline unsigned int
+__dzf_base_get_flags(void *self)
+{
+    return DZF_GET_BASE(self)->flags;
+}
+
+DZF_PRIVATE
+static inline Bool
+__dzf_base_has_flag(void *self,
+                    unsigned int flag)
+{
+    return (__dzf_base_get_flags(self) & flag) ? TRUE : FALSE;
+}
+
+DZF_PRIVATE
+static inline void
+__dzf_base_toggle_flag(void *self,
+                       unsigned int flag, Bool on)
+{
+    unsigned int flags = __dzf_base_get_flags(self);
+
+    __dzf_base_set_flags(self, on ? (flags | flag) : (flags & ~flag));
+}
+
+DZF_PRIVATE
+static inline void
+__dzf_base_set_grow_policy(void *self,
+                           unsigned int policy, size_t arg)
+{
+    DZF_GET_BASE(self)->grow_policy = policy;
+    DZF_GET_BASE(self)->grow_arg = arg;
+}
+
+DZF_PRIVATE
+static inline unsigned int
+__dzf_base_get_grow_policy(void *self)
+{
+    return DZF_GET_BASE(self)->grow_policy;
+}
+
+DZF_PRIVATE
+static inline size_t
+__dzf_base_get_grow_arg(void *self)
+{
+    return DZF_GET_BASE(self)->grow_arg;
+}
+
+DZF_PRIVATE
+static inline void
+__dzf_base_set_allocator(void *self,
+                         const dzf_allocator_t *allocator)
+{
+    DZF_GET_BASE(self)->allocator = allocator;
+}
+
+DZF_PRIVATE
+static inline const dzf_allocator_t *
+__dzf_base_get_allocator(void *self)
+{
+    return DZF_GET_BASE(self)->allocator;
+}
+
+DZF_PRIVATE
+static inline void
+__dzf_base_set_align(void *self,
+                     size_t align)
+{
+    DZF_GET_BASE(self)->align = align;
+}
+
+DZF_PRIVATE
+static inline size_t
+__dzf_base_get_align(void *self)
+{
+    return DZF_GET_BASE(self)->align;
+}
+
+/*
+ * Aligned blocks over-allocate 'align' plus a pointer from the allocator
+ * and keep the raw block right in front of the aligned one.
+ */
+DZF_PRIVATE
+static inline size_t
+__dzf_base_aligned_overhead(void *self)
+{
+    return __dzf_base_get_align(self) + sizeof(void *);
+}
+
+DZF_PRIVATE
+static inline void *
+__dzf_base_aligned_alloc(void *self,
+                         size_t bytes)
+{
+    const dzf_allocator_t *allocator = __dzf_base_get_allocator(self);
+    size_t align = __dzf_base_get_align(self);
+    uintptr_t addr;
+    void *raw;
+
+    if (bytes < 1)
+        return NULL;
+    if (bytes > SIZE_MAX - __dzf_base_aligned_overhead(self))
+        exit(-1);
+    bytes += __dzf_base_aligned_overhead(self);
+
+    if (!allocator)
+        raw = dzf_malloc(bytes);
+    else if (!(raw = allocator->alloc(allocator->ctx, bytes)))
+        exit(-1);
+
+    addr = ((uintptr_t)raw + sizeof(void *) + align - 1) & ~(uintptr_t)(align - 1);
+    ((void **)addr)[-1] = raw;
+
+    return (void *)addr;
+}
+
+DZF_PRIVATE
+static inline void
+__dzf_base_aligned_free(void *self, void *ptr,
+                        size_t bytes)
+{
+    const dzf_allocator_t *allocator = __dzf_base_get_allocator(self);
+    void *raw;
+
+    if (!ptr)
+        return;
+
+    raw = ((void **)ptr)[-1];
+    if (!allocator)
+        free(raw);
+    else
+        allocator->free(allocator->ctx, raw,
+                        bytes + __dzf_base_aligned_overhead(self));
+}
+
+/* plain realloc may hand back a block off the alignment, so copy instead */
+DZF_PRIVATE
+static inline void *
+__dzf_base_aligned_realloc(void *self, void *oldptr,
+                           size_t old_bytes, size_t new_bytes)
+{
+    void *newm = __dzf_base_aligned_alloc(self, new_bytes);
+
+    if (newm && oldptr)
+        memcpy(newm, oldptr, old_bytes < new_bytes ? old_bytes : new_bytes);
+    __dzf_base_aligned_free(self, oldptr, old_bytes);
+
+    return newm;
+}
+
+/* alloc buckets for 'nmemb' elems of 'size' from the allocator */
+DZF_PRIVATE
+static inline void *
+__dzf_base_alloc_array(void *self,
+                       size_t nmemb, size_t size)
+{
+    const dzf_allocator_t *allocator = __dzf_base_get_allocator(self);
+    size_t bytes = dzf_mul_size(nmemb, size);
+    void *newm;
+
+    if (__dzf_base_get_align(self))
+        return __dzf_base_aligned_alloc(self, bytes);
+
+    if (!allocator)
+        return dzf_malloc(bytes);
+
+    if (bytes < 1)
+        return NULL;
+    if (!(newm = allocator->alloc(allocator->ctx, bytes)))
+        exit(-1);
+
+    return newm;
+}
+
+DZF_PRIVATE
+static inline void *
+__dzf_base_realloc_array(void *self, void *oldptr,
+                         size_t old_nmemb, size_t new_nmemb, size_t size)
+{
+    const dzf_allocator_t *allocator = __dzf_base_get_allocator(self);
+    size_t bytes = dzf_mul_size(new_nmemb, size);
+    void *newm;
+
+    if (__dzf_base_get_align(self))
+        return __dzf_base_aligned_realloc(self, oldptr,
+                                          old_nmemb * size, bytes);
+
+    if (!allocator)
+        return dzf_realloc(oldptr, bytes);
+
+    if (bytes < 1)
+        return NULL;
+    if (!(newm = allocator->realloc(allocator->ctx, oldptr,
+                                    old_nmemb * size, bytes)))
+        exit(-1);
+
+    return newm;
+}
+
+DZF_PRIVATE
+static inline void
+__dzf_base_free_array(void *self, void *ptr,
+                      size_t nmemb, size_t size)
+{
+    const dzf_allocator_t *allocator = __dzf_base_get_allocator(self);
+
+    if (__dzf_base_get_align(self))
+        __dzf_base_aligned_free(self, ptr, nmemb * size);
+    else if (!allocator)
+        free(ptr);
+    else
+        allocator->free(allocator->ctx, ptr, nmemb * size);
+}
+
 DZF_PRIVATE
 static inline void
 __dzf_base_init(void *self,
-                int length, size_t capacity, size_t elem_size)
+                size_t length, size_t capacity, size_t elem_size)
 {
     __dzf_base_set_length(self, length);
     __dzf_base_set_capacity(self, capacity);
     __dzf_base_set_elem_size(self, elem_size);
+    __dzf_base_set_flags(self, 0);
+    __dzf_base_set_grow_policy(self, 0, 0);
+    /* resolved here once, in the unit that initializes the container */
+    __dzf_base_set_allocator(self, DZF_DEFAULT_ALLOCATOR);
+    __dzf_base_set_align(self, 0);
 }
 
 #endif /* DZF_BASE_H */
@@ -0,0 +1,352 @@
+/* dzf-cstack-priv.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef DZF_CSTACK_PRIV_H
+#define DZF_CSTACK_PRIV_H
+
+#if !defined (DZF_CSTACK_USE_AS_PRIVATE)
+#   error "Only <dzf/dzf-cstack.h> can be included directly!"
+#endif
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "dzf-util.h"
+
+#define DZF_BASE_USE_AS_PRIVATE
+#include "dzf-base.h"
+#undef  DZF_BASE_USE_AS_PRIVATE
+
+#define DZF_CSTACK_MAX_CHUNKS 32
+
+/* -- Type Definition -- */
+/*!
+ * @def dzf_cstack_t(T)
+ * @brief Concurrent stack type
+ *
+ * @param T: type of elems.
+ *
+ * Elems are kept in nodes that are never given back until 'data_free',
+ * and a node is named by its index plus one, '0' for none. Chunk 'k'
+ * holds 'chunk_size << k' nodes, so that an index maps onto a node
+ * without any lock as the chunks are added.
+ *
+ * Both 'head' and 'free_head' pack a node in the low 32 bits and a tag
+ * in the high 32 bits, which changes on every update to defeat ABA.
+ *
+ * \b Examples
+ * @code{.c}
+ *   typedef dzf_cstack_t(struct buf *) cstack_buf_t;
+ * @endcode
+ */
+#define dzf_cstack_t(T) \
+    struct { \
+        __dzf_base_t _unused1; \
+        _Alignas(DZF_CACHELINE_SIZE) atomic_uint_least64_t head; \
+        _Alignas(DZF_CACHELINE_SIZE) atomic_uint_least64_t free_head; \
+        _Alignas(DZF_CACHELINE_SIZE) atomic_size_t fresh; \
+        atomic_size_t count; \
+        size_t node_size; \
+        size_t elem_offset; \
+        size_t chunk_size; \
+        _Atomic(char *) chunks[DZF_CSTACK_MAX_CHUNKS]; \
+        T *elem_type; /* never accessed, types the elems */ \
+    }
+
+typedef dzf_cstack_t(void*)     __dzf_cstack_priv_void_t;
+#define DZF_CSTACK_VOID(self)   ((__dzf_cstack_priv_void_t*)self)
+
+#define DZF_CSTACK_ALLOC_SIZE 64 /* default number of nodes in the first chunk */
+
+typedef struct __dzf_cstack_node {
+    atomic_uint_least32_t next;
+    /* followed by an elem at 'elem_offset' */
+} __dzf_cstack_node_t;
+
+
+/* -- Private APIs -- */
+DZF_PRIVATE
+static inline size_t
+__dzf_cstack_elem_size(void *self)
+{
+    return __dzf_base_get_elem_size(self);
+}
+
+
+DZF_PRIVATE
+static inline uint_least32_t
+__dzf_cstack_tagged_node(uint_least64_t tagged)
+{
+    return (uint_least32_t)(tagged & UINT32_MAX);
+}
+
+
+/* point at 'node' with the tag of 'old' bumped */
+DZF_PRIVATE
+static inline uint_least64_t
+__dzf_cstack_tagged(uint_least64_t old,
+                    uint_least32_t node)
+{
+    return ((old >> 32) + 1) << 32 | node;
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_cstack_chunk_bytes(void *self,
+                         unsigned int k)
+{
+    __dzf_cstack_priv_void_t *cs = self;
+
+    return dzf_mul_size(cs->chunk_size << k, cs->node_size);
+}
+
+
+/* node 'n', '0' is none */
+DZF_PRIVATE
+static inline __dzf_cstack_node_t *
+__dzf_cstack_node(void *self,
+                  uint_least32_t n)
+{
+    __dzf_cstack_priv_void_t *cs = self;
+    size_t index = (size_t)n - 1;
+    size_t first = 0;
+    unsigned int k = 0;
+    char *chunk;
+
+    while (index - first >= cs->chunk_size << k) {
+        first += cs->chunk_size << k;
+        k++;
+    }
+    chunk = atomic_load_explicit(&cs->chunks[k], memory_order_acquire);
+
+    return (__dzf_cstack_node_t *)(chunk + (index - first) * cs->node_size);
+}
+
+
+DZF_PRIVATE
+static inline void *
+__dzf_cstack_node_elem(void *self,
+                       __dzf_cstack_node_t *node)
+{
+    return (char *)node + DZF_CSTACK_VOID(self)->elem_offset;
+}
+
+
+/* a node that has never been used, adding its chunk if nobody did */
+DZF_PRIVATE
+static inline uint_least32_t
+__dzf_cstack_fresh_node(void *self)
+{
+    __dzf_cstack_priv_void_t *cs = self;
+    size_t index = atomic_fetch_add_explicit(&cs->fresh, 1,
+                                             memory_order_relaxed);
+    size_t first = 0;
+    unsigned int k = 0;
+    char *chunk, *expected = NULL;
+
+    while (index - first >= cs->chunk_size << k) {
+        first += cs->chunk_size << k;
+        k++;
+    }
+    /* out of chunks or of 32-bit node names */
+    __die(k < DZF_CSTACK_MAX_CHUNKS && index < UINT32_MAX);
+
+    if (atomic_load_explicit(&cs->chunks[k], memory_order_acquire) == NULL) {
+        chunk = __dzf_base_alloc_array(cs, 1, __dzf_cstack_chunk_bytes(cs, k));
+        if (!atomic_compare_exchange_strong_explicit(&cs->chunks[k], &expected,
+                                                     chunk,
+                                                     memory_order_acq_rel,
+                                                     memory_order_acquire))
+            __dzf_base_free_array(cs, chunk, 1,
+                                  __dzf_cstack_chunk_bytes(cs, k));
+    }
+
+    return (uint_least32_t)(index + 1);
+}
+
+
+/* Treiber push of node 'n' onto the list at 'head' */
+DZF_PRIVATE
+static inline void
+__dzf_cstack_link(void *self,
+                  atomic_uint_least64_t *head, uint_least32_t n)
+{
+    __dzf_cstack_node_t *node = __dzf_cstack_node(self, n);
+    uint_least64_t old = atomic_load_explicit(head, memory_order_relaxed);
+
+    do {
+        atomic_store_explicit(&node->next, __dzf_cstack_tagged_node(old),
+                              memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(head, &old,
+                                                    __dzf_cstack_tagged(old, n),
+                                                    memory_order_release,
+                                                    memory_order_relaxed));
+}
+
+
+/* Treiber pop from the list at 'head', '0' if empty */
+DZF_PRIVATE
+static inline uint_least32_t
+__dzf_cstack_unlink(void *self,
+                    atomic_uint_least64_t *head)
+{
+    uint_least64_t old = atomic_load_explicit(head, memory_order_acquire);
+    uint_least32_t n, next;
+
+    do {
+        n = __dzf_cstack_tagged_node(old);
+        if (n == 0)
+            return 0;
+        /*
+         * The node may be popped and pushed again meanwhile, then the
+         * tag has changed and the stale 'next' never gets installed.
+         */
+        next = atomic_load_explicit(&__dzf_cstack_node(self, n)->next,
+                                    memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(head, &old,
+                                                    __dzf_cstack_tagged(old, next),
+                                                    memory_order_acquire,
+                                                    memory_order_acquire));
+
+    return n;
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_cstack_push(void *self,
+                  const void *elem)
+{
+    __dzf_cstack_priv_void_t *cs = self;
+    uint_least32_t n = __dzf_cstack_unlink(cs, &cs->free_head);
+
+    if (n == 0)
+        n = __dzf_cstack_fresh_node(cs);
+
+    memcpy(__dzf_cstack_node_elem(cs, __dzf_cstack_node(cs, n)), elem,
+           __dzf_cstack_elem_size(cs));
+
+    /*
+     * Count before linking: the release of the link orders the add before
+     * the fetch_sub of whichever popper takes the node, so the counter
+     * never wraps below zero, it may only run ahead of the list.
+     */
+    atomic_fetch_add_explicit(&cs->count, 1, memory_order_relaxed);
+    __dzf_cstack_link(cs, &cs->head, n);
+}
+
+
+DZF_PRIVATE
+static inline Bool
+__dzf_cstack_try_pop(void *self,
+                     void *out)
+{
+    __dzf_cstack_priv_void_t *cs = self;
+    uint_least32_t n = __dzf_cstack_unlink(cs, &cs->head);
+
+    if (n == 0)
+        return FALSE;
+
+    atomic_fetch_sub_explicit(&cs->count, 1, memory_order_relaxed);
+    memcpy(out, __dzf_cstack_node_elem(cs, __dzf_cstack_node(cs, n)),
+           __dzf_cstack_elem_size(cs));
+    __dzf_cstack_link(cs, &cs->free_head, n);
+
+    return TRUE;
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_cstack_size(void *self)
+{
+    __dzf_cstack_priv_void_t *cs = self;
+
+    /* a snapshot, it may be stale as soon as it returns */
+    return atomic_load_explicit(&cs->count, memory_order_relaxed);
+}
+
+
+DZF_PRIVATE
+static inline int
+__dzf_cstack_init(void *self,
+                  size_t elem_size, size_t elem_align, size_t chunk_size,
+                  const dzf_allocator_t *allocator)
+{
+    __dzf_cstack_priv_void_t *cs = self;
+    unsigned int k;
+
+    if (chunk_size <= DZF_CSTACK_ALLOC_SIZE)
+        chunk_size = DZF_CSTACK_ALLOC_SIZE;
+
+    __dzf_base_init(cs, 0, 0, elem_size);
+    if (allocator)
+        __dzf_base_set_allocator(cs, allocator);
+    atomic_init(&cs->head, 0);
+    atomic_init(&cs->free_head, 0);
+    atomic_init(&cs->fresh, 0);
+    atomic_init(&cs->count, 0);
+
+    /* the elem follows 'next' at its own alignment, 8 bytes at least */
+    if (elem_align < sizeof(uint_least64_t))
+        elem_align = sizeof(uint_least64_t);
+    __die(!(elem_align & (elem_align - 1)));
+    cs->elem_offset = elem_align;
+    cs->node_size = (elem_align + elem_size + elem_align - 1)
+                    & ~(elem_align - 1);
+    if (elem_align > _Alignof(max_align_t))
+        __dzf_base_set_align(cs, elem_align);   /* chunks, too */
+    cs->chunk_size = chunk_size;
+    for (k = 0; k < DZF_CSTACK_MAX_CHUNKS; k++)
+        atomic_init(&cs->chunks[k], NULL);
+
+    return 0;
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_cstack_data_free(void *self)
+{
+    __dzf_cstack_priv_void_t *cs = self;
+    unsigned int k;
+    char *chunk;
+
+    for (k = 0; k < DZF_CSTACK_MAX_CHUNKS; k++) {
+        chunk = atomic_load_explicit(&cs->chunks[k], memory_order_relaxed);
+        if (chunk != NULL)
+            __dzf_base_free_array(cs, chunk, 1,
+                                  __dzf_cstack_chunk_bytes(cs, k));
+        atomic_init(&cs->chunks[k], NULL);
+    }
+    atomic_init(&cs->head, 0);
+    atomic_init(&cs->free_head, 0);
+    atomic_init(&cs->fresh, 0);
+    atomic_init(&cs->count, 0);
+    __dzf_base_init(cs, 0, 0, 0);
+}
+
+#endif /* DZF_CSTACK_PRIV_H */
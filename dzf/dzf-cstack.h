@@ -0,0 +1,172 @@
+/* dzf-cstack.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! @file dzf-cstack.h
+ *
+ * @brief Concurrent Stack Type Structure.
+ *
+ * dzf_cstack_t(T) is a Treiber stack that any number of threads push
+ * onto and pop from without any lock, e.g. to recycle objects across
+ * threads. Unlike dzf_stack_t(T), every operation is a single CAS loop
+ * on an atomic head.
+ *
+ * Elems are copied into nodes from an internal lock-free free-list.
+ * It grows by chunks of nodes, the first one of '64' unless clarify it
+ * via initializer and each next one twice as large, and the nodes are
+ * given back only by 'data_free'. The heads carry a tag that changes
+ * on every update, so that a node which is popped and pushed again
+ * in the middle of a CAS loop cannot corrupt the stack (ABA). Elems
+ * keep the alignment of T in the nodes, which is why the initializers
+ * are macros.
+ *
+ * It requires a C11 compiler for atomics.
+ *
+ * Note that neither of initializers nor 'data_free' is thread-safe.
+ *
+ * \b Examples
+ * @code{.c}
+ *   dzf_cstack_t(struct buf *) cs;
+ *   struct buf *b;
+ *
+ *   dzf_cstack_new(&cs, sizeof(struct buf *));
+ *   dzf_cstack_push(&cs, &b);
+ *   if (dzf_cstack_try_pop(&cs, &b)) ...
+ *   dzf_cstack_data_free(&cs);
+ * @endcode
+ */
+
+#ifndef DZF_CSTACK_H
+#define DZF_CSTACK_H
+
+#define DZF_CSTACK_USE_AS_PRIVATE
+#include "dzf-cstack-priv.h"
+
+
+/*!
+ * Initialize a dzf_cstack_t(T) instance whose nodes come from the
+ * allocator.
+ *
+ * @param self: an instance of dzf_cstack_t(T).
+ * @param elem_size: each element size in byte unit.
+ * @param chunk_size: number of nodes in the first chunk.
+ * @param allocator: a thread-safe allocator that outlives the stack,
+ *                   NULL for default.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+#define dzf_cstack_init_with_allocator(self, elem_size, chunk_size, allocator) \
+    ( \
+      __die(self), \
+      __dzf_cstack_init(self, elem_size, dzf_alignof(*(self)->elem_type), \
+                        chunk_size, allocator) \
+    )
+
+/*!
+ * Initialize a dzf_cstack_t(T) instance.
+ *
+ * No node is allocated until the first push.
+ *
+ * @param self: an instance of dzf_cstack_t(T).
+ * @param elem_size: each element size in byte unit.
+ * @param chunk_size: number of nodes in the first chunk.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+#define dzf_cstack_init(self, elem_size, chunk_size) \
+    dzf_cstack_init_with_allocator(self, elem_size, chunk_size, NULL)
+
+/*!
+ * Initialize a dzf_cstack_t(T) instance with the first chunk of '64'.
+ *
+ * @param self: an instance of dzf_cstack_t(T).
+ * @param elem_size: each element size in byte unit.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+#define dzf_cstack_new(self, elem_size) \
+    dzf_cstack_init_with_allocator(self, elem_size, DZF_CSTACK_ALLOC_SIZE, NULL)
+
+/*!
+ * Free all nodes of dzf_cstack_t(T).
+ *
+ * @param self: an instance of dzf_cstack_t(T).
+ * @return none
+ */
+DZF_PUBLIC
+static inline void
+dzf_cstack_data_free(void *self)
+{
+    __die(self);
+
+    __dzf_cstack_data_free(self);
+}
+
+/*!
+ * Get the number of elems in dzf_cstack_t(T).
+ *
+ * Note that it is a snapshot under concurrent access.
+ *
+ * @param self: an instance of dzf_cstack_t(T).
+ * @return the number of elems.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_cstack_size(void *self)
+{
+    __die(self);
+
+    return __dzf_cstack_size(self);
+}
+
+/*!
+ * Push a value onto dzf_cstack_t(T).
+ *
+ * @param self: an instance of dzf_cstack_t(T).
+ * @param ptr: a pointer to T to copy the value from.
+ * @return none
+ */
+DZF_PUBLIC
+#define dzf_cstack_push(self, ptr) \
+    ( \
+      __die(self), \
+      __die(sizeof(*(ptr)) == sizeof(*(self)->elem_type)), \
+      __dzf_cstack_push(self, ptr) \
+    )
+
+/*!
+ * Try to pop the latest value from dzf_cstack_t(T).
+ *
+ * @param self: an instance of dzf_cstack_t(T).
+ * @param out: a pointer to T that receives the value.
+ * @return TRUE on success, FALSE if empty.
+ */
+DZF_PUBLIC
+#define dzf_cstack_try_pop(self, out) \
+    ( \
+      __die(self), \
+      __die(sizeof(*(out)) == sizeof(*(self)->elem_type)), \
+      __dzf_cstack_try_pop(self, out) \
+    )
+
+#endif /* DZF_CSTACK_H */
@@ -0,0 +1,136 @@
+/* dzf-deque-priv.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef DZF_DEQUE_PRIV_H
+#define DZF_DEQUE_PRIV_H
+
+#if !defined (DZF_DEQUE_USE_AS_PRIVATE)
+#   error "Only <dzf/dzf-deque.h> can be included directly!"
+#endif
+
+#define DZF_QUEUE_USE_AS_PRIVATE
+#include "dzf-queue-priv.h"
+#undef  DZF_QUEUE_USE_AS_PRIVATE
+
+/* -- Type Definition -- */
+/*!
+ * @def dzf_deque_t(T)
+ * @brief Double-ended queue type
+ *
+ * @param T: type that represents an elem of 'data' array.
+ *
+ * It is laid out the same as dzf_queue_t(T), a power of two ring whose
+ * free running 'head' and 'tail' counters may move either way.
+ *
+ * \b Examples
+ * @code{.c}
+ *   typedef dzf_deque_t(int) deque_int_t;
+ *   typedef dzf_deque_t(struct _job *) deque_job_t;
+ * @endcode
+ */
+#define dzf_deque_t(T) \
+    struct { \
+        __dzf_base_t _unused1; \
+        size_t head; \
+        size_t tail; \
+        T *data; \
+        T hold_elem; \
+    }
+
+typedef dzf_deque_t(void*)     __dzf_deque_priv_void_t;
+#define DZF_DEQUE_VOID(self)   ((__dzf_deque_priv_void_t*)self)
+
+#define DZF_DEQUE_ALLOC_SIZE 16 /* default capacity, must be a power of two */
+
+
+/* -- Private APIs -- */
+DZF_PRIVATE
+static inline int
+__dzf_deque_init(void *self,
+                 size_t elem_size, size_t capacity,
+                 const dzf_allocator_t *allocator)
+{
+    if (capacity <= DZF_DEQUE_ALLOC_SIZE)
+        capacity = DZF_DEQUE_ALLOC_SIZE;
+
+    __dzf_queue_init(self, elem_size, capacity, allocator);
+    __dzf_base_toggle_flag(self, DZF_BASE_FLAG_GROWABLE, TRUE);
+
+    return 0;
+}
+
+
+/* bucket of the 'index'th elem from the head */
+DZF_PRIVATE
+static inline size_t
+__dzf_deque_index(void *self,
+                  size_t index)
+{
+    __die(index < __dzf_queue_size(self));
+
+    return (__dzf_queue_head(self) + index) & __dzf_queue_mask(self);
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_deque_grow_if_full(void *self)
+{
+    return __dzf_queue_is_full(self) ? __dzf_queue_try_growing(self) : 0;
+}
+
+
+/* called under early 'grow_if_full' */
+DZF_PRIVATE
+static inline size_t
+__dzf_deque_retreat_head(void *self)
+{
+    __dzf_deque_priv_void_t *dq = self;
+
+    return --dq->head & __dzf_queue_mask(dq);
+}
+
+
+/* called under early 'queue_is_empty' */
+DZF_PRIVATE
+static inline size_t
+__dzf_deque_retreat_tail(void *self)
+{
+    __dzf_deque_priv_void_t *dq = self;
+
+    return --dq->tail & __dzf_queue_mask(dq);
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_deque_clear(void *self)
+{
+    __dzf_deque_priv_void_t *dq = self;
+
+    dq->head = 0;
+    dq->tail = 0;
+}
+
+#endif /* DZF_DEQUE_PRIV_H */
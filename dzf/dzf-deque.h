@@ -0,0 +1,313 @@
+/* dzf-deque.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! @file dzf-deque.h
+ *
+ * @brief Double-Ended Queue Type Structure.
+ *
+ * dzf_deque_t(T) pushes and pops at both the head and the tail in O(1),
+ * and reads or writes any elem by its index from the head in O(1).
+ * Default capacity is '16' unless clarify it via initializer, and it
+ * is always rounded up to a power of two.
+ *
+ * It is a growable ring as dzf_queue_t(T) is, so that adding at the
+ * head never moves the other elems, unlike 'dzf_ved_add_head'. Once it
+ * is full, the ring doubles.
+ *
+ * \b Examples
+ * @code{.c}
+ *   dzf_deque_t(int) dq;
+ *
+ *   dzf_deque_new(&dq, sizeof(int));
+ *   dzf_deque_push_tail(&dq, 1);
+ *   dzf_deque_push_head(&dq, 0);
+ *   printf("%d\n", dzf_deque_get(&dq, 1));  // 1
+ *   dzf_deque_data_free(&dq);
+ * @endcode
+ */
+
+#ifndef DZF_DEQUE_H
+#define DZF_DEQUE_H
+
+#define DZF_DEQUE_USE_AS_PRIVATE
+#include "dzf-deque-priv.h"
+
+
+/*!
+ * Initialize a dzf_deque_t(T) instance whose buckets come from the
+ * allocator.
+ *
+ * @param self: an instance of dzf_deque_t(T).
+ * @param elem_size: each element size in byte unit.
+ * @param capacity: number of elements in the deque.
+ * @param allocator: an allocator that outlives the deque, NULL for default.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_deque_init_with_allocator(void *self,
+                              size_t elem_size, size_t capacity,
+                              const dzf_allocator_t *allocator)
+{
+    __die(self);
+
+    return __dzf_deque_init(self, elem_size, capacity, allocator);
+}
+
+/*!
+ * Initialize a dzf_deque_t(T) instance.
+ *
+ * @param self: an instance of dzf_deque_t(T).
+ * @param elem_size: each element size in byte unit.
+ * @param capacity: number of elements in the deque.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_deque_init(void *self,
+               size_t elem_size, size_t capacity)
+{
+    __die(self);
+
+    return __dzf_deque_init(self, elem_size, capacity, NULL);
+}
+
+/*!
+ * Initialize a dzf_deque_t(T) instance with capacity '16'.
+ *
+ * @param self: an instance of dzf_deque_t(T).
+ * @param elem_size: each element size in byte unit.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_deque_new(void *self,
+              size_t elem_size)
+{
+    __die(self);
+
+    return __dzf_deque_init(self, elem_size, DZF_DEQUE_ALLOC_SIZE, NULL);
+}
+
+/*!
+ * Free buckets of dzf_deque_t(T).
+ *
+ * @param self: an instance of dzf_deque_t(T).
+ * @return none
+ */
+DZF_PUBLIC
+static inline void
+dzf_deque_data_free(void *self)
+{
+    __die(self);
+
+    __dzf_queue_data_free(self);
+}
+
+/*!
+ * Remove all elems of dzf_deque_t(T), keeping its buckets.
+ *
+ * @param self: an instance of dzf_deque_t(T).
+ * @return none
+ */
+DZF_PUBLIC
+static inline void
+dzf_deque_clear(void *self)
+{
+    __die(self);
+
+    __dzf_deque_clear(self);
+}
+
+/*!
+ * Get the number of elems in dzf_deque_t(T).
+ *
+ * @param self: an instance of dzf_deque_t(T).
+ * @return the number of elems.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_deque_size(void *self)
+{
+    __die(self);
+
+    return __dzf_queue_size(self);
+}
+
+/*!
+ * Get the capacity of dzf_deque_t(T).
+ *
+ * @param self: an instance of dzf_deque_t(T).
+ * @return the capacity.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_deque_capacity(void *self)
+{
+    __die(self);
+
+    return __dzf_queue_capacity(self);
+}
+
+/*!
+ * Is dzf_deque_t(T) empty?
+ *
+ * @param self: an instance of dzf_deque_t(T).
+ * @return TRUE if empty, otherwise FALSE.
+ */
+DZF_PUBLIC
+static inline Bool
+dzf_deque_is_empty(void *self)
+{
+    __die(self);
+
+    return __dzf_queue_is_empty(self);
+}
+
+/*!
+ * Push a value at the head of dzf_deque_t(T).
+ *
+ * @param self: an instance of dzf_deque_t(T).
+ * @param _val: a new value.
+ * @return none
+ */
+DZF_PUBLIC
+#define dzf_deque_push_head(self, _val) \
+    ( \
+      __die(self), \
+      __dzf_deque_grow_if_full(self), \
+      (self)->data[__dzf_deque_retreat_head(self)] = (_val), \
+      (void)0 \
+    )
+
+/*!
+ * Push a value at the tail of dzf_deque_t(T).
+ *
+ * @param self: an instance of dzf_deque_t(T).
+ * @param _val: a new value.
+ * @return none
+ */
+DZF_PUBLIC
+#define dzf_deque_push_tail(self, _val) \
+    ( \
+      __die(self), \
+      __dzf_deque_grow_if_full(self), \
+      __dzf_queue_push_tail(self, _val) \
+    )
+
+/*!
+ * Pop a value from the head of dzf_deque_t(T).
+ *
+ * Note that it dies if the deque is empty.
+ *
+ * @param self: an instance of dzf_deque_t(T).
+ * @return the value at the head.
+ */
+DZF_PUBLIC
+#define dzf_deque_pop_head(self) \
+    ( \
+      __die(self), \
+      __die(!__dzf_queue_is_empty(self)), \
+      __dzf_queue_pop_head(self) \
+    )
+
+/*!
+ * Pop a value from the tail of dzf_deque_t(T).
+ *
+ * Note that it dies if the deque is empty.
+ *
+ * @param self: an instance of dzf_deque_t(T).
+ * @return the value at the tail.
+ */
+DZF_PUBLIC
+#define dzf_deque_pop_tail(self) \
+    ( \
+      __die(self), \
+      __die(!__dzf_queue_is_empty(self)), \
+      (self)->hold_elem = (self)->data[__dzf_deque_retreat_tail(self)], \
+      (self)->hold_elem \
+    )
+
+/*!
+ * Get the value at an index from the head of dzf_deque_t(T).
+ *
+ * Note that it dies if the index is out of range.
+ *
+ * @param self: an instance of dzf_deque_t(T).
+ * @param idx: an index, '0' for the head.
+ * @return the value.
+ */
+DZF_PUBLIC
+#define dzf_deque_get(self, idx) \
+    ( \
+      __die(self), \
+      (self)->data[__dzf_deque_index(self, idx)] \
+    )
+
+/*!
+ * Set the value at an index from the head of dzf_deque_t(T).
+ *
+ * Note that it dies if the index is out of range.
+ *
+ * @param self: an instance of dzf_deque_t(T).
+ * @param idx: an index, '0' for the head.
+ * @param _val: a new value.
+ * @return none
+ */
+DZF_PUBLIC
+#define dzf_deque_set(self, idx, _val) \
+    ( \
+      __die(self), \
+      (self)->data[__dzf_deque_index(self, idx)] = (_val), \
+      (void)0 \
+    )
+
+/*!
+ * Get the value at the head of dzf_deque_t(T) without popping it.
+ *
+ * @param self: an instance of dzf_deque_t(T).
+ * @return the value at the head.
+ */
+DZF_PUBLIC
+#define dzf_deque_front(self) \
+    dzf_deque_get(self, 0)
+
+/*!
+ * Get the value at the tail of dzf_deque_t(T) without popping it.
+ *
+ * @param self: an instance of dzf_deque_t(T).
+ * @return the value at the tail.
+ */
+DZF_PUBLIC
+#define dzf_deque_back(self) \
+    dzf_deque_get(self, __dzf_queue_size(self) - 1)
+
+DZF_PUBLIC
+#define dzf_deque_foreach(self, _fptr, ...) \
+    for ( size_t i = 0; \
+          i < __dzf_queue_size(self); \
+          (_fptr)(&((self)->data[__dzf_deque_index(self, i)]), __VA_ARGS__), \
+          ++i )
+
+#endif /* DZF_DEQUE_H */
@@ -0,0 +1,429 @@
+/* dzf-hmap-priv.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef DZF_HMAP_PRIV_H
+#define DZF_HMAP_PRIV_H
+
+#if !defined (DZF_HMAP_USE_AS_PRIVATE)
+#   error "Only <dzf/dzf-hmap.h> can be included directly!"
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#include "dzf-util.h"
+
+#define DZF_BASE_USE_AS_PRIVATE
+#include "dzf-base.h"
+#undef  DZF_BASE_USE_AS_PRIVATE
+
+typedef dzf_hash_fn __dzf_hmap_hash_fn;
+typedef dzf_eq_fn   __dzf_hmap_eq_fn;
+
+/* -- Type Definition -- */
+/*!
+ * @def dzf_hmap_t(K, V)
+ * @brief Hash map type
+ *
+ * @param K: type of keys.
+ * @param V: type of values.
+ *
+ * 'data' holds 'capacity' buckets of key-value entries plus two more
+ * as scratch, and 'dists' holds the probe distance of each bucket
+ * plus one, '0' for an empty one.
+ *
+ * \b Examples
+ * @code{.c}
+ *   typedef dzf_hmap_t(int, double) hmap_int_double_t;
+ *   typedef dzf_hmap_t(char *, struct _node) hmap_str_node_t;
+ * @endcode
+ */
+#define dzf_hmap_t(K, V) \
+    struct { \
+        __dzf_base_t _unused1; \
+        uint32_t *dists; \
+        __dzf_hmap_hash_fn hash; \
+        __dzf_hmap_eq_fn eq; \
+        size_t key_size; \
+        size_t value_offset; \
+        struct { K key; V value; } *data, hold; \
+        V *hold_value; \
+    }
+
+typedef dzf_hmap_t(char, char) __dzf_hmap_priv_void_t;
+#define DZF_HMAP_VOID(self) ((__dzf_hmap_priv_void_t*)self)
+
+#define DZF_HMAP_ALLOC_SIZE 16 /* default number of buckets */
+
+
+/* -- Private APIs -- */
+DZF_PRIVATE
+static inline size_t
+__dzf_hmap_hash_bytes(const void *key,
+                      size_t key_size)
+{
+    const unsigned char *p = key;
+    uint64_t h = UINT64_C(14695981039346656037);    /* FNV-1a */
+
+    while (key_size--) {
+        h ^= *p++;
+        h *= UINT64_C(1099511628211);
+    }
+
+    return (size_t)h;
+}
+
+
+DZF_PRIVATE
+static inline Bool
+__dzf_hmap_eq_bytes(const void *a, const void *b,
+                    size_t key_size)
+{
+    return (memcmp(a, b, key_size) == 0 ? TRUE : FALSE);
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_hmap_size(void *self)
+{
+    return __dzf_base_get_length(self);
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_hmap_capacity(void *self)
+{
+    return __dzf_base_get_capacity(self);
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_hmap_entry_size(void *self)
+{
+    return __dzf_base_get_elem_size(self);
+}
+
+
+DZF_PRIVATE
+static inline void *
+__dzf_hmap_get_ptr_at(void *self,
+                      size_t index)
+{
+    __dzf_hmap_priv_void_t *map = self;
+
+    return (char *)map->data + index * __dzf_hmap_entry_size(map);
+}
+
+
+/* spread a user hash over all bits, since user hashes may be weak */
+DZF_PRIVATE
+static inline uint64_t
+__dzf_hmap_mix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= UINT64_C(0xff51afd7ed558ccd);
+    h ^= h >> 33;
+
+    return h;
+}
+
+
+/* home bucket of 'key' */
+DZF_PRIVATE
+static inline size_t
+__dzf_hmap_home(void *self,
+                const void *key)
+{
+    __dzf_hmap_priv_void_t *map = self;
+    uint64_t h = __dzf_hmap_mix(map->hash(key, map->key_size));
+
+    return (size_t)h & (__dzf_hmap_capacity(map) - 1);
+}
+
+
+/* bucket that holds 'key', -1 if not found */
+DZF_PRIVATE
+static inline ptrdiff_t
+__dzf_hmap_find(void *self,
+                const void *key)
+{
+    __dzf_hmap_priv_void_t *map = self;
+    size_t mask = __dzf_hmap_capacity(map) - 1;
+    size_t i = __dzf_hmap_home(map, key);
+    uint32_t dist = 1;
+
+    /* a richer bucket than us means the key would have been placed here */
+    while (map->dists[i] >= dist) {
+        if (map->dists[i] == dist
+            && map->eq(__dzf_hmap_get_ptr_at(map, i), key, map->key_size))
+            return (ptrdiff_t)i;
+        i = (i + 1) & mask;
+        dist++;
+    }
+
+    return -1;
+}
+
+
+/* place an entry known to be absent, robbing the richer buckets */
+DZF_PRIVATE
+static inline void
+__dzf_hmap_place(void *self,
+                 const void *entry)
+{
+    __dzf_hmap_priv_void_t *map = self;
+    size_t es = __dzf_hmap_entry_size(map);
+    size_t mask = __dzf_hmap_capacity(map) - 1;
+    void *carry = __dzf_hmap_get_ptr_at(map, mask + 1);
+    void *tmp = __dzf_hmap_get_ptr_at(map, mask + 2);
+    size_t i;
+    uint32_t dist = 1, d;
+
+    memcpy(carry, entry, es);
+    i = __dzf_hmap_home(map, carry);
+
+    while (map->dists[i] != 0) {
+        if (map->dists[i] < dist) {
+            memcpy(tmp, __dzf_hmap_get_ptr_at(map, i), es);
+            memcpy(__dzf_hmap_get_ptr_at(map, i), carry, es);
+            memcpy(carry, tmp, es);
+            d = map->dists[i];
+            map->dists[i] = dist;
+            dist = d;
+        }
+        i = (i + 1) & mask;
+        dist++;
+    }
+
+    memcpy(__dzf_hmap_get_ptr_at(map, i), carry, es);
+    map->dists[i] = dist;
+    __dzf_base_set_length(map, __dzf_hmap_size(map) + 1);
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_hmap_alloc_buckets(void *self,
+                         size_t capacity)
+{
+    __dzf_hmap_priv_void_t *map = self;
+
+    /* two more entries as scratch for swapping */
+    map->data = (void *)__dzf_base_alloc_array(map, capacity + 2,
+                                               __dzf_hmap_entry_size(map));
+    map->dists = __dzf_base_alloc_array(map, capacity, sizeof(uint32_t));
+    memset(map->dists, 0, capacity * sizeof(uint32_t));
+    __dzf_base_set_capacity(map, capacity);
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_hmap_free_buckets(void *self,
+                        void *data, uint32_t *dists, size_t capacity)
+{
+    __dzf_base_free_array(self, data, capacity + 2,
+                          __dzf_hmap_entry_size(self));
+    __dzf_base_free_array(self, dists, capacity, sizeof(uint32_t));
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_hmap_rehash(void *self,
+                  size_t new_capacity)
+{
+    __dzf_hmap_priv_void_t *map = self;
+    size_t old_capacity = __dzf_hmap_capacity(map);
+    void *old_data = map->data;
+    uint32_t *old_dists = map->dists;
+    size_t es = __dzf_hmap_entry_size(map);
+    size_t i;
+
+    __dzf_hmap_alloc_buckets(map, new_capacity);
+    __dzf_base_set_length(map, 0);
+
+    for (i = 0; i < old_capacity; i++)
+        if (old_dists[i] != 0)
+            __dzf_hmap_place(map, (char *)old_data + i * es);
+
+    __dzf_hmap_free_buckets(map, old_data, old_dists, old_capacity);
+
+    return new_capacity;
+}
+
+
+/* keep the load factor under 7/8 */
+DZF_PRIVATE
+static inline Bool
+__dzf_hmap_is_full(void *self)
+{
+    size_t capacity = __dzf_hmap_capacity(self);
+
+    return (__dzf_hmap_size(self) >= capacity - capacity / 8 ? TRUE : FALSE);
+}
+
+
+DZF_PRIVATE
+static inline int
+__dzf_hmap_init(void *self,
+                size_t key_size, size_t value_offset, size_t entry_size,
+                size_t capacity,
+                __dzf_hmap_hash_fn hash, __dzf_hmap_eq_fn eq,
+                const dzf_allocator_t *allocator)
+{
+    __dzf_hmap_priv_void_t *map = self;
+
+    if (capacity <= DZF_HMAP_ALLOC_SIZE)
+        capacity = DZF_HMAP_ALLOC_SIZE;
+    capacity = dzf_next_pow2(capacity);
+
+    __dzf_base_init(map, 0, 0, entry_size);
+    if (allocator)
+        __dzf_base_set_allocator(map, allocator);
+    map->hash = hash ? hash : __dzf_hmap_hash_bytes;
+    map->eq = eq ? eq : __dzf_hmap_eq_bytes;
+    map->key_size = key_size;
+    map->value_offset = value_offset;
+    __dzf_hmap_alloc_buckets(map, capacity);
+
+    return 0;
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_hmap_data_free(void *self)
+{
+    __dzf_hmap_priv_void_t *map = self;
+
+    if (map->data != NULL) {
+        __dzf_hmap_free_buckets(map, map->data, map->dists,
+                                __dzf_hmap_capacity(map));
+        map->data = NULL;
+        map->dists = NULL;
+    }
+    __dzf_base_init(map, 0, 0, 0);
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_hmap_clear(void *self)
+{
+    __dzf_hmap_priv_void_t *map = self;
+
+    memset(map->dists, 0, __dzf_hmap_capacity(map) * sizeof(uint32_t));
+    __dzf_base_set_length(map, 0);
+}
+
+
+/* returns TRUE if 'entry' is new, otherwise its value is overwritten */
+DZF_PRIVATE
+static inline Bool
+__dzf_hmap_put(void *self,
+               const void *entry)
+{
+    __dzf_hmap_priv_void_t *map = self;
+    ptrdiff_t i = __dzf_hmap_find(map, entry);
+
+    if (i >= 0) {
+        memcpy(__dzf_hmap_get_ptr_at(map, (size_t)i), entry,
+               __dzf_hmap_entry_size(map));
+        return FALSE;
+    }
+
+    if (__dzf_hmap_is_full(map))
+        __dzf_hmap_rehash(map, __dzf_hmap_capacity(map) * 2);
+    __dzf_hmap_place(map, entry);
+
+    return TRUE;
+}
+
+
+/* pointer to the value of 'key', NULL if not found */
+DZF_PRIVATE
+static inline void *
+__dzf_hmap_get(void *self,
+               const void *key)
+{
+    __dzf_hmap_priv_void_t *map = self;
+    ptrdiff_t i = __dzf_hmap_find(map, key);
+
+    if (i < 0)
+        return NULL;
+
+    return (char *)__dzf_hmap_get_ptr_at(map, (size_t)i) + map->value_offset;
+}
+
+
+/* backward-shift deletion, no tombstones are left behind */
+DZF_PRIVATE
+static inline Bool
+__dzf_hmap_remove(void *self,
+                  const void *key)
+{
+    __dzf_hmap_priv_void_t *map = self;
+    size_t mask = __dzf_hmap_capacity(map) - 1;
+    ptrdiff_t found = __dzf_hmap_find(map, key);
+    size_t i, j;
+
+    if (found < 0)
+        return FALSE;
+
+    /* pull the following displaced entries one bucket closer to home */
+    i = (size_t)found;
+    j = (i + 1) & mask;
+    while (map->dists[j] > 1) {
+        memcpy(__dzf_hmap_get_ptr_at(map, i), __dzf_hmap_get_ptr_at(map, j),
+               __dzf_hmap_entry_size(map));
+        map->dists[i] = map->dists[j] - 1;
+        i = j;
+        j = (j + 1) & mask;
+    }
+    map->dists[i] = 0;
+    __dzf_base_set_length(map, __dzf_hmap_size(map) - 1);
+
+    return TRUE;
+}
+
+
+/* first occupied bucket from 'index', 'capacity' if none */
+DZF_PRIVATE
+static inline size_t
+__dzf_hmap_next(void *self,
+                size_t index)
+{
+    __dzf_hmap_priv_void_t *map = self;
+
+    while (index < __dzf_hmap_capacity(map) && map->dists[index] == 0)
+        index++;
+
+    return index;
+}
+
+#endif /* DZF_HMAP_PRIV_H */
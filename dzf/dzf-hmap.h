@@ -0,0 +1,331 @@
+/* dzf-hmap.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! @file dzf-hmap.h
+ *
+ * @brief Hash Map Type Structure.
+ *
+ * dzf_hmap_t(K, V) maps keys of K onto values of V with open addressing.
+ * Default capacity is '16' buckets unless clarify it via initializer,
+ * and it is always rounded up to a power of two. The map doubles once
+ * it is loaded over 7/8.
+ *
+ * Collisions are resolved by Robin Hood linear probing, so that every
+ * lookup walks a short run of neighbouring buckets. Removing shifts the
+ * following entries back instead of leaving tombstones.
+ *
+ * Keys are hashed and compared byte-wise unless hash and equality
+ * functions are given, e.g. 'dzf_hmap_hash_str' and 'dzf_hmap_eq_str'
+ * for 'char *' keys. Both receive pointers to keys.
+ *
+ * \b Examples
+ * @code{.c}
+ *   dzf_hmap_t(int, double) map;
+ *   double *v;
+ *
+ *   dzf_hmap_new(&map, NULL, NULL);
+ *   dzf_hmap_put(&map, 7, 0.5);
+ *   v = dzf_hmap_get(&map, 7);
+ *   ...
+ *   dzf_hmap_data_free(&map);
+ * @endcode
+ */
+
+#ifndef DZF_HMAP_H
+#define DZF_HMAP_H
+
+#define DZF_HMAP_USE_AS_PRIVATE
+#include "dzf-hmap-priv.h"
+
+
+/*!
+ * Hash a key byte-wise, the default hash function.
+ *
+ * @param key: a pointer to a key.
+ * @param key_size: size of the key in byte unit.
+ * @return a hash value.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_hmap_hash_bytes(const void *key,
+                    size_t key_size)
+{
+    return __dzf_hmap_hash_bytes(key, key_size);
+}
+
+/*!
+ * Compare keys byte-wise, the default equality function.
+ *
+ * @param a: a pointer to a key.
+ * @param b: a pointer to another key.
+ * @param key_size: size of the keys in byte unit.
+ * @return TRUE if equal, otherwise FALSE.
+ */
+DZF_PUBLIC
+static inline Bool
+dzf_hmap_eq_bytes(const void *a, const void *b,
+                  size_t key_size)
+{
+    return __dzf_hmap_eq_bytes(a, b, key_size);
+}
+
+/*!
+ * Hash a 'char *' key by the string it points to.
+ *
+ * @param key: a pointer to a 'char *' key.
+ * @param key_size: unused.
+ * @return a hash value.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_hmap_hash_str(const void *key,
+                  size_t key_size)
+{
+    const char *str = *(char *const *)key;
+
+    (void)key_size;
+    return __dzf_hmap_hash_bytes(str, strlen(str));
+}
+
+/*!
+ * Compare 'char *' keys by the strings they point to.
+ *
+ * @param a: a pointer to a 'char *' key.
+ * @param b: a pointer to another 'char *' key.
+ * @param key_size: unused.
+ * @return TRUE if equal, otherwise FALSE.
+ */
+DZF_PUBLIC
+static inline Bool
+dzf_hmap_eq_str(const void *a, const void *b,
+                size_t key_size)
+{
+    (void)key_size;
+    return (strcmp(*(char *const *)a, *(char *const *)b) == 0 ? TRUE : FALSE);
+}
+
+/*!
+ * Initialize a dzf_hmap_t(K, V) instance whose buckets come from the
+ * allocator.
+ *
+ * @param self: an instance of dzf_hmap_t(K, V).
+ * @param capacity: number of buckets.
+ * @param hash: a dzf_hash_fn of keys, NULL for byte-wise.
+ * @param eq: a dzf_eq_fn of keys, NULL for byte-wise.
+ * @param allocator: an allocator that outlives the map, NULL for default.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+#define dzf_hmap_init_with_allocator(self, capacity, hash, eq, allocator) \
+    ( \
+      __die(self), \
+      __dzf_hmap_init(self, sizeof((self)->hold.key), \
+                      (size_t)((char *)&(self)->hold.value \
+                               - (char *)&(self)->hold), \
+                      sizeof((self)->hold), \
+                      capacity, hash, eq, allocator) \
+    )
+
+/*!
+ * Initialize a dzf_hmap_t(K, V) instance.
+ *
+ * @param self: an instance of dzf_hmap_t(K, V).
+ * @param capacity: number of buckets.
+ * @param hash: a dzf_hash_fn of keys, NULL for byte-wise.
+ * @param eq: a dzf_eq_fn of keys, NULL for byte-wise.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+#define dzf_hmap_init(self, capacity, hash, eq) \
+    dzf_hmap_init_with_allocator(self, capacity, hash, eq, NULL)
+
+/*!
+ * Initialize a dzf_hmap_t(K, V) instance with capacity '16'.
+ *
+ * @param self: an instance of dzf_hmap_t(K, V).
+ * @param hash: a dzf_hash_fn of keys, NULL for byte-wise.
+ * @param eq: a dzf_eq_fn of keys, NULL for byte-wise.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+#define dzf_hmap_new(self, hash, eq) \
+    dzf_hmap_init(self, DZF_HMAP_ALLOC_SIZE, hash, eq)
+
+/*!
+ * Free buckets of dzf_hmap_t(K, V).
+ *
+ * Note that the keys and values are not freed.
+ *
+ * @param self: an instance of dzf_hmap_t(K, V).
+ * @return none
+ */
+DZF_PUBLIC
+static inline void
+dzf_hmap_data_free(void *self)
+{
+    __die(self);
+
+    __dzf_hmap_data_free(self);
+}
+
+/*!
+ * Remove all entries of dzf_hmap_t(K, V), keeping its buckets.
+ *
+ * @param self: an instance of dzf_hmap_t(K, V).
+ * @return none
+ */
+DZF_PUBLIC
+static inline void
+dzf_hmap_clear(void *self)
+{
+    __die(self);
+
+    __dzf_hmap_clear(self);
+}
+
+/*!
+ * Get the number of entries in dzf_hmap_t(K, V).
+ *
+ * @param self: an instance of dzf_hmap_t(K, V).
+ * @return the number of entries.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_hmap_size(void *self)
+{
+    __die(self);
+
+    return __dzf_hmap_size(self);
+}
+
+/*!
+ * Get the number of buckets of dzf_hmap_t(K, V).
+ *
+ * @param self: an instance of dzf_hmap_t(K, V).
+ * @return the capacity.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_hmap_capacity(void *self)
+{
+    __die(self);
+
+    return __dzf_hmap_capacity(self);
+}
+
+/*!
+ * Is dzf_hmap_t(K, V) empty?
+ *
+ * @param self: an instance of dzf_hmap_t(K, V).
+ * @return TRUE if empty, otherwise FALSE.
+ */
+DZF_PUBLIC
+static inline Bool
+dzf_hmap_is_empty(void *self)
+{
+    __die(self);
+
+    return (__dzf_hmap_size(self) == 0 ? TRUE : FALSE);
+}
+
+/*!
+ * Map a key onto a value in dzf_hmap_t(K, V).
+ *
+ * The value of an existing key is overwritten.
+ *
+ * @param self: an instance of dzf_hmap_t(K, V).
+ * @param _key: a key.
+ * @param _val: a value.
+ * @return TRUE if the key is new, otherwise FALSE.
+ */
+DZF_PUBLIC
+#define dzf_hmap_put(self, _key, _val) \
+    ( \
+      __die(self), \
+      (self)->hold.key = (_key), \
+      (self)->hold.value = (_val), \
+      __dzf_hmap_put(self, &(self)->hold) \
+    )
+
+/*!
+ * Look up the value of a key in dzf_hmap_t(K, V).
+ *
+ * The pointer stays valid until the map is modified.
+ *
+ * @param self: an instance of dzf_hmap_t(K, V).
+ * @param _key: a key.
+ * @return a pointer to V, NULL if not found.
+ */
+DZF_PUBLIC
+#define dzf_hmap_get(self, _key) \
+    ( \
+      __die(self), \
+      (self)->hold.key = (_key), \
+      (self)->hold_value = __dzf_hmap_get(self, &(self)->hold.key), \
+      (self)->hold_value \
+    )
+
+/*!
+ * Does dzf_hmap_t(K, V) contain a key?
+ *
+ * @param self: an instance of dzf_hmap_t(K, V).
+ * @param _key: a key.
+ * @return TRUE if found, otherwise FALSE.
+ */
+DZF_PUBLIC
+#define dzf_hmap_contains(self, _key) \
+    (dzf_hmap_get(self, _key) != NULL ? TRUE : FALSE)
+
+/*!
+ * Remove a key and its value from dzf_hmap_t(K, V).
+ *
+ * @param self: an instance of dzf_hmap_t(K, V).
+ * @param _key: a key.
+ * @return TRUE if removed, FALSE if not found.
+ */
+DZF_PUBLIC
+#define dzf_hmap_remove(self, _key) \
+    ( \
+      __die(self), \
+      (self)->hold.key = (_key), \
+      __dzf_hmap_remove(self, &(self)->hold.key) \
+    )
+
+/*!
+ * Call a function on every entry of dzf_hmap_t(K, V), in no order.
+ *
+ * The function takes a pointer to K, a pointer to V and the rest.
+ *
+ * @param self: an instance of dzf_hmap_t(K, V).
+ * @param _fptr: a function to call.
+ */
+DZF_PUBLIC
+#define dzf_hmap_foreach(self, _fptr, ...) \
+    for ( size_t i = __dzf_hmap_next(self, 0); \
+          i < __dzf_hmap_capacity(self); \
+          (_fptr)(&((self)->data[i].key), &((self)->data[i].value), \
+                  __VA_ARGS__), \
+          i = __dzf_hmap_next(self, i + 1) )
+
+#endif /* DZF_HMAP_H */
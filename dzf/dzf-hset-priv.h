@@ -0,0 +1,484 @@
+/* dzf-hset-priv.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef DZF_HSET_PRIV_H
+#define DZF_HSET_PRIV_H
+
+#if !defined (DZF_HSET_USE_AS_PRIVATE)
+#   error "Only <dzf/dzf-hset.h> can be included directly!"
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+/* scan control groups with SSE2 unless told not to */
+#if defined(__SSE2__) && !defined(DZF_HSET_NO_SIMD)
+#   define DZF_HSET_SSE2
+#   include <emmintrin.h>
+#endif
+
+#define DZF_HMAP_USE_AS_PRIVATE
+#include "dzf-hmap-priv.h"  /* hash functions */
+#undef  DZF_HMAP_USE_AS_PRIVATE
+
+/* -- Type Definition -- */
+/*!
+ * @def dzf_hset_t(T)
+ * @brief Hash set type
+ *
+ * @param T: type of elems.
+ *
+ * 'data' holds 'capacity' buckets of T, and 'ctrl' holds a control byte
+ * per bucket, either 'DZF_HSET_EMPTY', 'DZF_HSET_DELETED' or 7 bits of
+ * the hash of a full bucket. The first 'DZF_HSET_GROUP - 1' control
+ * bytes are mirrored past the end, so that any group of them is read
+ * in one load.
+ *
+ * \b Examples
+ * @code{.c}
+ *   typedef dzf_hset_t(uint64_t) hset_u64_t;
+ *   typedef dzf_hset_t(char *) hset_str_t;
+ * @endcode
+ */
+#define dzf_hset_t(T) \
+    struct { \
+        __dzf_base_t _unused1; \
+        int8_t *ctrl; \
+        size_t growth_left; \
+        __dzf_hmap_hash_fn hash; \
+        __dzf_hmap_eq_fn eq; \
+        T *data; \
+        T hold_elem; \
+    }
+
+typedef dzf_hset_t(char) __dzf_hset_priv_void_t;
+#define DZF_HSET_VOID(self) ((__dzf_hset_priv_void_t*)self)
+
+#define DZF_HSET_ALLOC_SIZE 16  /* default number of buckets */
+#define DZF_HSET_GROUP      16  /* control bytes scanned at once */
+
+#define DZF_HSET_EMPTY   ((int8_t)-128)
+#define DZF_HSET_DELETED ((int8_t)-2)
+
+
+/* -- Private APIs -- */
+DZF_PRIVATE
+static inline unsigned int
+__dzf_hset_ctz(unsigned int bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned int)__builtin_ctz(bits);
+#else
+    unsigned int n = 0;
+
+    while (!(bits & 1u)) {
+        bits >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+
+/* leading zeros of a 16-bit group mask */
+DZF_PRIVATE
+static inline unsigned int
+__dzf_hset_clz16(unsigned int bits)
+{
+    unsigned int n = 0;
+
+    while (!(bits & 0x8000u)) {
+        bits <<= 1;
+        n++;
+    }
+    return n;
+}
+
+
+/* bit 'i' is set where group[i] == h2 */
+DZF_PRIVATE
+static inline unsigned int
+__dzf_hset_match(const int8_t *group,
+                 int8_t h2)
+{
+#if defined(DZF_HSET_SSE2)
+    __m128i g = _mm_loadu_si128((const __m128i *)group);
+
+    return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), g));
+#else
+    unsigned int bits = 0, i;
+
+    for (i = 0; i < DZF_HSET_GROUP; i++)
+        bits |= (unsigned int)(group[i] == h2) << i;
+    return bits;
+#endif
+}
+
+
+/* bit 'i' is set where group[i] is empty or deleted */
+DZF_PRIVATE
+static inline unsigned int
+__dzf_hset_match_free(const int8_t *group)
+{
+#if defined(DZF_HSET_SSE2)
+    __m128i g = _mm_loadu_si128((const __m128i *)group);
+
+    /* full buckets are non-negative */
+    return (unsigned int)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), g));
+#else
+    unsigned int bits = 0, i;
+
+    for (i = 0; i < DZF_HSET_GROUP; i++)
+        bits |= (unsigned int)(group[i] < -1) << i;
+    return bits;
+#endif
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_hset_size(void *self)
+{
+    return __dzf_base_get_length(self);
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_hset_capacity(void *self)
+{
+    return __dzf_base_get_capacity(self);
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_hset_elem_size(void *self)
+{
+    return __dzf_base_get_elem_size(self);
+}
+
+
+DZF_PRIVATE
+static inline void *
+__dzf_hset_get_ptr_at(void *self,
+                      size_t index)
+{
+    __dzf_hset_priv_void_t *set = self;
+
+    return set->data + index * __dzf_hset_elem_size(set);
+}
+
+
+DZF_PRIVATE
+static inline uint64_t
+__dzf_hset_hash(void *self,
+                const void *elem)
+{
+    __dzf_hset_priv_void_t *set = self;
+
+    return __dzf_hmap_mix(set->hash(elem, __dzf_hset_elem_size(set)));
+}
+
+
+/* write a control byte and its mirror past the end */
+DZF_PRIVATE
+static inline void
+__dzf_hset_set_ctrl(void *self,
+                    size_t index, int8_t c)
+{
+    __dzf_hset_priv_void_t *set = self;
+    size_t mask = __dzf_hset_capacity(set) - 1;
+
+    set->ctrl[index] = c;
+    set->ctrl[((index - (DZF_HSET_GROUP - 1)) & mask) + (DZF_HSET_GROUP - 1)] = c;
+}
+
+
+/* elems a table of 'capacity' may hold, 7/8 of it */
+DZF_PRIVATE
+static inline size_t
+__dzf_hset_max_load(size_t capacity)
+{
+    return capacity - capacity / 8;
+}
+
+
+/* bucket that holds 'elem', -1 if not found */
+DZF_PRIVATE
+static inline ptrdiff_t
+__dzf_hset_find(void *self,
+                const void *elem)
+{
+    __dzf_hset_priv_void_t *set = self;
+    size_t mask = __dzf_hset_capacity(set) - 1;
+    uint64_t h = __dzf_hset_hash(set, elem);
+    int8_t h2 = (int8_t)(h & 0x7f);
+    size_t pos = (size_t)(h >> 7) & mask;
+    size_t step = 0;
+    unsigned int bits;
+    size_t i;
+
+    for (;;) {
+        const int8_t *group = set->ctrl + pos;
+
+        for (bits = __dzf_hset_match(group, h2); bits; bits &= bits - 1) {
+            i = (pos + __dzf_hset_ctz(bits)) & mask;
+            if (set->eq(__dzf_hset_get_ptr_at(set, i), elem,
+                        __dzf_hset_elem_size(set)))
+                return (ptrdiff_t)i;
+        }
+
+        /* an empty bucket ends the probe sequence */
+        if (__dzf_hset_match(group, DZF_HSET_EMPTY))
+            return -1;
+
+        /* triangular probing visits every group of a power of two */
+        step += DZF_HSET_GROUP;
+        pos = (pos + step) & mask;
+    }
+}
+
+
+/* first empty or deleted bucket along the probe sequence of 'h' */
+DZF_PRIVATE
+static inline size_t
+__dzf_hset_find_free(void *self,
+                     uint64_t h)
+{
+    __dzf_hset_priv_void_t *set = self;
+    size_t mask = __dzf_hset_capacity(set) - 1;
+    size_t pos = (size_t)(h >> 7) & mask;
+    size_t step = 0;
+    unsigned int bits;
+
+    while (!(bits = __dzf_hset_match_free(set->ctrl + pos))) {
+        step += DZF_HSET_GROUP;
+        pos = (pos + step) & mask;
+    }
+
+    return (pos + __dzf_hset_ctz(bits)) & mask;
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_hset_alloc_buckets(void *self,
+                         size_t capacity)
+{
+    __dzf_hset_priv_void_t *set = self;
+    size_t ctrl_size = capacity + DZF_HSET_GROUP - 1;
+
+    set->data = __dzf_base_alloc_array(set, capacity,
+                                       __dzf_hset_elem_size(set));
+    set->ctrl = __dzf_base_alloc_array(set, ctrl_size, 1);
+    memset(set->ctrl, DZF_HSET_EMPTY, ctrl_size);
+    set->growth_left = __dzf_hset_max_load(capacity);
+    __dzf_base_set_capacity(set, capacity);
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_hset_free_buckets(void *self,
+                        void *data, int8_t *ctrl, size_t capacity)
+{
+    __dzf_base_free_array(self, data, capacity, __dzf_hset_elem_size(self));
+    __dzf_base_free_array(self, ctrl, capacity + DZF_HSET_GROUP - 1, 1);
+}
+
+
+/* place an elem known to be absent into a bucket ready for it */
+DZF_PRIVATE
+static inline void
+__dzf_hset_place(void *self,
+                 const void *elem, uint64_t h)
+{
+    __dzf_hset_priv_void_t *set = self;
+    size_t i = __dzf_hset_find_free(set, h);
+
+    if (set->ctrl[i] == DZF_HSET_EMPTY)
+        set->growth_left--;
+    __dzf_hset_set_ctrl(set, i, (int8_t)(h & 0x7f));
+    memcpy(__dzf_hset_get_ptr_at(set, i), elem, __dzf_hset_elem_size(set));
+    __dzf_base_set_length(set, __dzf_hset_size(set) + 1);
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_hset_rehash(void *self,
+                  size_t new_capacity)
+{
+    __dzf_hset_priv_void_t *set = self;
+    size_t old_capacity = __dzf_hset_capacity(set);
+    char *old_data = set->data;
+    int8_t *old_ctrl = set->ctrl;
+    size_t es = __dzf_hset_elem_size(set);
+    size_t i;
+
+    __dzf_hset_alloc_buckets(set, new_capacity);
+    __dzf_base_set_length(set, 0);
+
+    for (i = 0; i < old_capacity; i++)
+        if (old_ctrl[i] >= 0)
+            __dzf_hset_place(set, old_data + i * es,
+                             __dzf_hset_hash(set, old_data + i * es));
+
+    __dzf_hset_free_buckets(set, old_data, old_ctrl, old_capacity);
+
+    return new_capacity;
+}
+
+
+DZF_PRIVATE
+static inline int
+__dzf_hset_init(void *self,
+                size_t elem_size, size_t capacity,
+                __dzf_hmap_hash_fn hash, __dzf_hmap_eq_fn eq,
+                const dzf_allocator_t *allocator)
+{
+    __dzf_hset_priv_void_t *set = self;
+
+    if (capacity <= DZF_HSET_ALLOC_SIZE)
+        capacity = DZF_HSET_ALLOC_SIZE;
+    capacity = dzf_next_pow2(capacity);
+
+    __dzf_base_init(set, 0, 0, elem_size);
+    if (allocator)
+        __dzf_base_set_allocator(set, allocator);
+    set->hash = hash ? hash : __dzf_hmap_hash_bytes;
+    set->eq = eq ? eq : __dzf_hmap_eq_bytes;
+    __dzf_hset_alloc_buckets(set, capacity);
+
+    return 0;
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_hset_data_free(void *self)
+{
+    __dzf_hset_priv_void_t *set = self;
+
+    if (set->data != NULL) {
+        __dzf_hset_free_buckets(set, set->data, set->ctrl,
+                                __dzf_hset_capacity(set));
+        set->data = NULL;
+        set->ctrl = NULL;
+    }
+    set->growth_left = 0;
+    __dzf_base_init(set, 0, 0, 0);
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_hset_clear(void *self)
+{
+    __dzf_hset_priv_void_t *set = self;
+    size_t capacity = __dzf_hset_capacity(set);
+
+    memset(set->ctrl, DZF_HSET_EMPTY, capacity + DZF_HSET_GROUP - 1);
+    set->growth_left = __dzf_hset_max_load(capacity);
+    __dzf_base_set_length(set, 0);
+}
+
+
+/* returns TRUE if 'elem' is new */
+DZF_PRIVATE
+static inline Bool
+__dzf_hset_insert(void *self,
+                  const void *elem)
+{
+    __dzf_hset_priv_void_t *set = self;
+    size_t capacity = __dzf_hset_capacity(set);
+
+    if (__dzf_hset_find(set, elem) >= 0)
+        return FALSE;
+
+    if (set->growth_left == 0) {
+        /* purge tombstones in place unless it is really loaded */
+        if (__dzf_hset_size(set) * 2 < __dzf_hset_max_load(capacity))
+            __dzf_hset_rehash(set, capacity);
+        else
+            __dzf_hset_rehash(set, capacity * 2);
+    }
+    __dzf_hset_place(set, elem, __dzf_hset_hash(set, elem));
+
+    return TRUE;
+}
+
+
+DZF_PRIVATE
+static inline Bool
+__dzf_hset_remove(void *self,
+                  const void *elem)
+{
+    __dzf_hset_priv_void_t *set = self;
+    size_t mask = __dzf_hset_capacity(set) - 1;
+    ptrdiff_t found = __dzf_hset_find(set, elem);
+    unsigned int before, after;
+    size_t i;
+
+    if (found < 0)
+        return FALSE;
+
+    /*
+     * The bucket may turn empty only if no probe sequence has ever
+     * passed over it as a full group, i.e. the run of full buckets
+     * around it is shorter than a group.
+     */
+    i = (size_t)found;
+    before = __dzf_hset_match(set->ctrl + ((i - DZF_HSET_GROUP) & mask),
+                              DZF_HSET_EMPTY);
+    after = __dzf_hset_match(set->ctrl + i, DZF_HSET_EMPTY);
+    if (before && after
+        && __dzf_hset_ctz(after) + __dzf_hset_clz16(before) < DZF_HSET_GROUP) {
+        __dzf_hset_set_ctrl(set, i, DZF_HSET_EMPTY);
+        set->growth_left++;
+    } else {
+        __dzf_hset_set_ctrl(set, i, DZF_HSET_DELETED);
+    }
+    __dzf_base_set_length(set, __dzf_hset_size(set) - 1);
+
+    return TRUE;
+}
+
+
+/* first full bucket from 'index', 'capacity' if none */
+DZF_PRIVATE
+static inline size_t
+__dzf_hset_next(void *self,
+                size_t index)
+{
+    __dzf_hset_priv_void_t *set = self;
+
+    while (index < __dzf_hset_capacity(set) && set->ctrl[index] < 0)
+        index++;
+
+    return index;
+}
+
+#endif /* DZF_HSET_PRIV_H */
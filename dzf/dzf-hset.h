@@ -0,0 +1,262 @@
+/* dzf-hset.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! @file dzf-hset.h
+ *
+ * @brief Hash Set Type Structure.
+ *
+ * dzf_hset_t(T) keeps a set of T with open addressing in Swiss table
+ * style. Default capacity is '16' buckets unless clarify it via
+ * initializer, and it is always rounded up to a power of two. The set
+ * doubles once it is loaded over 7/8.
+ *
+ * Besides the dense bucket array, every bucket has a control byte with
+ * 7 bits of its hash. A lookup compares 16 control bytes at once, with
+ * SSE2 where available, so that it usually touches a single bucket.
+ * Define 'DZF_HSET_NO_SIMD' to use the portable scalar scan instead.
+ *
+ * Elems are hashed and compared byte-wise unless hash and equality
+ * functions are given, in the same form as for dzf_hmap_t(K, V).
+ *
+ * \b Examples
+ * @code{.c}
+ *   dzf_hset_t(uint64_t) set;
+ *
+ *   dzf_hset_new(&set, sizeof(uint64_t), NULL, NULL);
+ *   dzf_hset_insert(&set, 42);
+ *   if (dzf_hset_contains(&set, 42))
+ *   ...
+ *   dzf_hset_data_free(&set);
+ * @endcode
+ */
+
+#ifndef DZF_HSET_H
+#define DZF_HSET_H
+
+#define DZF_HSET_USE_AS_PRIVATE
+#include "dzf-hset-priv.h"
+
+
+/*!
+ * Initialize a dzf_hset_t(T) instance whose buckets come from the
+ * allocator.
+ *
+ * @param self: an instance of dzf_hset_t(T).
+ * @param elem_size: each element size in byte unit.
+ * @param capacity: number of buckets.
+ * @param hash: a hash function of elems, NULL for byte-wise.
+ * @param eq: an equality function of elems, NULL for byte-wise.
+ * @param allocator: an allocator that outlives the set, NULL for default.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_hset_init_with_allocator(void *self,
+                             size_t elem_size, size_t capacity,
+                             dzf_hash_fn hash, dzf_eq_fn eq,
+                             const dzf_allocator_t *allocator)
+{
+    __die(self);
+
+    return __dzf_hset_init(self, elem_size, capacity, hash, eq, allocator);
+}
+
+/*!
+ * Initialize a dzf_hset_t(T) instance.
+ *
+ * @param self: an instance of dzf_hset_t(T).
+ * @param elem_size: each element size in byte unit.
+ * @param capacity: number of buckets.
+ * @param hash: a hash function of elems, NULL for byte-wise.
+ * @param eq: an equality function of elems, NULL for byte-wise.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_hset_init(void *self,
+              size_t elem_size, size_t capacity,
+              dzf_hash_fn hash, dzf_eq_fn eq)
+{
+    __die(self);
+
+    return __dzf_hset_init(self, elem_size, capacity, hash, eq, NULL);
+}
+
+/*!
+ * Initialize a dzf_hset_t(T) instance with capacity '16'.
+ *
+ * @param self: an instance of dzf_hset_t(T).
+ * @param elem_size: each element size in byte unit.
+ * @param hash: a hash function of elems, NULL for byte-wise.
+ * @param eq: an equality function of elems, NULL for byte-wise.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_hset_new(void *self,
+             size_t elem_size,
+             dzf_hash_fn hash, dzf_eq_fn eq)
+{
+    __die(self);
+
+    return __dzf_hset_init(self, elem_size, DZF_HSET_ALLOC_SIZE,
+                           hash, eq, NULL);
+}
+
+/*!
+ * Free buckets of dzf_hset_t(T).
+ *
+ * Note that the elems themselves are not freed.
+ *
+ * @param self: an instance of dzf_hset_t(T).
+ * @return none
+ */
+DZF_PUBLIC
+static inline void
+dzf_hset_data_free(void *self)
+{
+    __die(self);
+
+    __dzf_hset_data_free(self);
+}
+
+/*!
+ * Remove all elems of dzf_hset_t(T), keeping its buckets.
+ *
+ * @param self: an instance of dzf_hset_t(T).
+ * @return none
+ */
+DZF_PUBLIC
+static inline void
+dzf_hset_clear(void *self)
+{
+    __die(self);
+
+    __dzf_hset_clear(self);
+}
+
+/*!
+ * Get the number of elems in dzf_hset_t(T).
+ *
+ * @param self: an instance of dzf_hset_t(T).
+ * @return the number of elems.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_hset_size(void *self)
+{
+    __die(self);
+
+    return __dzf_hset_size(self);
+}
+
+/*!
+ * Get the number of buckets of dzf_hset_t(T).
+ *
+ * @param self: an instance of dzf_hset_t(T).
+ * @return the capacity.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_hset_capacity(void *self)
+{
+    __die(self);
+
+    return __dzf_hset_capacity(self);
+}
+
+/*!
+ * Is dzf_hset_t(T) empty?
+ *
+ * @param self: an instance of dzf_hset_t(T).
+ * @return TRUE if empty, otherwise FALSE.
+ */
+DZF_PUBLIC
+static inline Bool
+dzf_hset_is_empty(void *self)
+{
+    __die(self);
+
+    return (__dzf_hset_size(self) == 0 ? TRUE : FALSE);
+}
+
+/*!
+ * Insert a value into dzf_hset_t(T).
+ *
+ * @param self: an instance of dzf_hset_t(T).
+ * @param _val: a value.
+ * @return TRUE if the value is new, otherwise FALSE.
+ */
+DZF_PUBLIC
+#define dzf_hset_insert(self, _val) \
+    ( \
+      __die(self), \
+      (self)->hold_elem = (_val), \
+      __dzf_hset_insert(self, &(self)->hold_elem) \
+    )
+
+/*!
+ * Does dzf_hset_t(T) contain a value?
+ *
+ * @param self: an instance of dzf_hset_t(T).
+ * @param _val: a value.
+ * @return TRUE if found, otherwise FALSE.
+ */
+DZF_PUBLIC
+#define dzf_hset_contains(self, _val) \
+    ( \
+      __die(self), \
+      (self)->hold_elem = (_val), \
+      (__dzf_hset_find(self, &(self)->hold_elem) >= 0 ? TRUE : FALSE) \
+    )
+
+/*!
+ * Remove a value from dzf_hset_t(T).
+ *
+ * @param self: an instance of dzf_hset_t(T).
+ * @param _val: a value.
+ * @return TRUE if removed, FALSE if not found.
+ */
+DZF_PUBLIC
+#define dzf_hset_remove(self, _val) \
+    ( \
+      __die(self), \
+      (self)->hold_elem = (_val), \
+      __dzf_hset_remove(self, &(self)->hold_elem) \
+    )
+
+/*!
+ * Call a function on every elem of dzf_hset_t(T), in no order.
+ *
+ * @param self: an instance of dzf_hset_t(T).
+ * @param _fptr: a function to call, taking a pointer to T and the rest.
+ */
+DZF_PUBLIC
+#define dzf_hset_foreach(self, _fptr, ...) \
+    for ( size_t i = __dzf_hset_next(self, 0); \
+          i < __dzf_hset_capacity(self); \
+          (_fptr)(&((self)->data[i]), __VA_ARGS__), \
+          i = __dzf_hset_next(self, i + 1) )
+
+#endif /* DZF_HSET_H */
@@ -0,0 +1,276 @@
+/* dzf-magazine-priv.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef DZF_MAGAZINE_PRIV_H
+#define DZF_MAGAZINE_PRIV_H
+
+#if !defined (DZF_MAGAZINE_USE_AS_PRIVATE)
+#   error "Only <dzf/dzf-magazine.h> can be included directly!"
+#endif
+
+#define DZF_STACK_USE_AS_PRIVATE
+#include "dzf-stack-priv.h"     /* magazines */
+#undef  DZF_STACK_USE_AS_PRIVATE
+
+#define DZF_CSTACK_USE_AS_PRIVATE
+#include "dzf-cstack-priv.h"    /* the depot */
+#undef  DZF_CSTACK_USE_AS_PRIVATE
+
+#define DZF_MAGAZINE_SIZE 64 /* default number of elems per magazine */
+
+/* -- Type Definition -- */
+/*
+ * A magazine is a heap allocated dzf_stack_t(T) that never grows. The
+ * depot is shared by all threads and keeps the magazines that no thread
+ * is holding, the ones with any elems on 'full' and the rest on 'empty'.
+ */
+typedef struct dzf_depot {
+    __dzf_base_t _unused1;  /* 'alloc_size' is the magazine size */
+    dzf_cstack_t(__dzf_stack_priv_void_t *) full;
+    dzf_cstack_t(__dzf_stack_priv_void_t *) empty;
+} dzf_depot_t;
+
+/*!
+ * @def dzf_mag_cache_t(T)
+ * @brief Thread-local magazine cache type
+ *
+ * @param T: type of elems.
+ *
+ * Elems come and go through 'loaded' first, then 'previous', and only
+ * when both of them are exhausted, a whole magazine is exchanged with
+ * the depot.
+ *
+ * \b Examples
+ * @code{.c}
+ *   typedef dzf_mag_cache_t(struct buf *) mag_cache_buf_t;
+ * @endcode
+ */
+#define dzf_mag_cache_t(T) \
+    struct { \
+        dzf_stack_t(T) *loaded, *previous; \
+        dzf_depot_t *depot; \
+    }
+
+typedef dzf_mag_cache_t(char)      __dzf_mag_cache_priv_void_t;
+#define DZF_MAG_CACHE_VOID(self)   ((__dzf_mag_cache_priv_void_t*)self)
+
+
+/* -- Private APIs -- */
+DZF_PRIVATE
+static inline size_t
+__dzf_depot_mag_size(dzf_depot_t *depot)
+{
+    return __dzf_base_get_capacity(depot);
+}
+
+
+DZF_PRIVATE
+static inline void *
+__dzf_depot_new_mag(dzf_depot_t *depot)
+{
+    __dzf_stack_priv_void_t *mag;
+
+    mag = __dzf_base_alloc_array(depot, 1, sizeof(*mag));
+    __dzf_stack_init(mag, __dzf_base_get_elem_size(depot),
+                     __dzf_depot_mag_size(depot),
+                     __dzf_base_get_allocator(depot));
+
+    return mag;
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_depot_free_mag(dzf_depot_t *depot,
+                     __dzf_stack_priv_void_t *mag)
+{
+    __dzf_stack_data_free(mag);
+    __dzf_base_free_array(depot, mag, 1, sizeof(*mag));
+}
+
+
+/* a magazine with some elems, NULL if none */
+DZF_PRIVATE
+static inline void *
+__dzf_depot_get_full(dzf_depot_t *depot)
+{
+    __dzf_stack_priv_void_t *mag;
+
+    return __dzf_cstack_try_pop(&depot->full, &mag) ? mag : NULL;
+}
+
+
+/* an empty magazine, a new one if none */
+DZF_PRIVATE
+static inline void *
+__dzf_depot_get_empty(dzf_depot_t *depot)
+{
+    __dzf_stack_priv_void_t *mag;
+
+    return __dzf_cstack_try_pop(&depot->empty, &mag)
+           ? mag : __dzf_depot_new_mag(depot);
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_depot_put(dzf_depot_t *depot,
+                void *mag)
+{
+    if (__dzf_stack_is_empty(mag))
+        __dzf_cstack_push(&depot->empty, &mag);
+    else
+        __dzf_cstack_push(&depot->full, &mag);
+}
+
+
+DZF_PRIVATE
+static inline int
+__dzf_depot_init(dzf_depot_t *depot,
+                 size_t elem_size, size_t mag_size,
+                 const dzf_allocator_t *allocator)
+{
+    if (mag_size == 0)
+        mag_size = DZF_MAGAZINE_SIZE;
+
+    __dzf_base_init(depot, 0, mag_size, elem_size);
+    if (allocator)
+        __dzf_base_set_allocator(depot, allocator);
+    __dzf_cstack_init(&depot->full, sizeof(void *), _Alignof(void *), 0,
+                      allocator);
+    __dzf_cstack_init(&depot->empty, sizeof(void *), _Alignof(void *), 0,
+                      allocator);
+
+    return 0;
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_depot_data_free(dzf_depot_t *depot)
+{
+    __dzf_stack_priv_void_t *mag;
+
+    while (__dzf_cstack_try_pop(&depot->full, &mag))
+        __dzf_depot_free_mag(depot, mag);
+    while (__dzf_cstack_try_pop(&depot->empty, &mag))
+        __dzf_depot_free_mag(depot, mag);
+
+    __dzf_cstack_data_free(&depot->full);
+    __dzf_cstack_data_free(&depot->empty);
+    __dzf_base_init(depot, 0, 0, 0);
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_mag_cache_swap(__dzf_mag_cache_priv_void_t *cache)
+{
+    void *tmp = cache->loaded;
+
+    cache->loaded = cache->previous;
+    cache->previous = tmp;
+}
+
+
+DZF_PRIVATE
+static inline int
+__dzf_mag_cache_init(void *self,
+                     dzf_depot_t *depot)
+{
+    __dzf_mag_cache_priv_void_t *cache = self;
+
+    cache->depot = depot;
+    cache->loaded = __dzf_depot_get_empty(depot);
+    cache->previous = __dzf_depot_get_empty(depot);
+
+    return 0;
+}
+
+
+/* the magazines may hold more, but are cut at the size of the depot */
+DZF_PRIVATE
+static inline Bool
+__dzf_mag_cache_is_full(void *self)
+{
+    __dzf_mag_cache_priv_void_t *cache = self;
+
+    return (__dzf_stack_size(cache->loaded) >= __dzf_depot_mag_size(cache->depot)
+            ? TRUE : FALSE);
+}
+
+
+/* called when 'loaded' is full */
+DZF_PRIVATE
+static inline void
+__dzf_mag_cache_make_room(void *self)
+{
+    __dzf_mag_cache_priv_void_t *cache = self;
+
+    if (!__dzf_stack_is_empty(cache->previous)) {
+        /* 'previous' holds elems too, trade it for an empty one */
+        __dzf_depot_put(cache->depot, cache->previous);
+        cache->previous = __dzf_depot_get_empty(cache->depot);
+    }
+    __dzf_mag_cache_swap(cache);
+}
+
+
+/* called when 'loaded' is empty, FALSE if nothing anywhere */
+DZF_PRIVATE
+static inline Bool
+__dzf_mag_cache_refill(void *self)
+{
+    __dzf_mag_cache_priv_void_t *cache = self;
+    void *full;
+
+    if (__dzf_stack_is_empty(cache->previous)) {
+        /* both are empty, trade one for a full one */
+        full = __dzf_depot_get_full(cache->depot);
+        if (full == NULL)
+            return FALSE;
+        __dzf_depot_put(cache->depot, cache->previous);
+        cache->previous = full;
+    }
+    __dzf_mag_cache_swap(cache);
+
+    return TRUE;
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_mag_cache_flush(void *self)
+{
+    __dzf_mag_cache_priv_void_t *cache = self;
+
+    if (cache->loaded != NULL)
+        __dzf_depot_put(cache->depot, cache->loaded);
+    if (cache->previous != NULL)
+        __dzf_depot_put(cache->depot, cache->previous);
+    cache->loaded = NULL;
+    cache->previous = NULL;
+}
+
+#endif /* DZF_MAGAZINE_PRIV_H */
@@ -0,0 +1,189 @@
+/* dzf-magazine.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! @file dzf-magazine.h
+ *
+ * @brief Thread-Local Magazine Cache.
+ *
+ * dzf_mag_cache_t(T) is a per-thread cache in front of a dzf_depot_t
+ * that all threads share, e.g. to recycle objects across threads. Each
+ * thread pushes and pops on small stacks of its own, called magazines,
+ * so that the common case touches no shared cache line at all. Only
+ * when both of its magazines run full or empty, a whole magazine of
+ * '64' elems, unless clarify it via initializer, is exchanged with the
+ * depot through a lock-free dzf_cstack_t.
+ *
+ * A cache must be used by a single thread, e.g. kept in a thread-local
+ * variable, and flushed before the thread exits. Elems don't return in
+ * LIFO order across threads.
+ *
+ * Note that neither of depot initializers nor 'dzf_depot_data_free' is
+ * thread-safe, and every cache must be flushed before the latter.
+ *
+ * \b Examples
+ * @code{.c}
+ *   static dzf_depot_t depot;
+ *   static _Thread_local dzf_mag_cache_t(struct buf *) cache;
+ *   struct buf *b;
+ *
+ *   dzf_depot_init(&depot, sizeof(struct buf *), 0);  // once
+ *   dzf_mag_cache_init(&cache, &depot);                // per thread
+ *   dzf_mag_cache_push(&cache, b);
+ *   if (dzf_mag_cache_try_pop(&cache, &b)) ...
+ *   dzf_mag_cache_flush(&cache);
+ * @endcode
+ */
+
+#ifndef DZF_MAGAZINE_H
+#define DZF_MAGAZINE_H
+
+#define DZF_MAGAZINE_USE_AS_PRIVATE
+#include "dzf-magazine-priv.h"
+
+
+/*!
+ * Initialize a dzf_depot_t instance whose magazines come from the
+ * allocator.
+ *
+ * @param depot: an instance of dzf_depot_t.
+ * @param elem_size: each element size in byte unit.
+ * @param mag_size: number of elems per magazine, 0 for default.
+ * @param allocator: a thread-safe allocator that outlives the depot,
+ *                   NULL for default.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_depot_init_with_allocator(dzf_depot_t *depot,
+                              size_t elem_size, size_t mag_size,
+                              const dzf_allocator_t *allocator)
+{
+    __die(depot);
+
+    return __dzf_depot_init(depot, elem_size, mag_size, allocator);
+}
+
+/*!
+ * Initialize a dzf_depot_t instance.
+ *
+ * @param depot: an instance of dzf_depot_t.
+ * @param elem_size: each element size in byte unit.
+ * @param mag_size: number of elems per magazine, 0 for default.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_depot_init(dzf_depot_t *depot,
+               size_t elem_size, size_t mag_size)
+{
+    __die(depot);
+
+    return __dzf_depot_init(depot, elem_size, mag_size, NULL);
+}
+
+/*!
+ * Free all magazines in dzf_depot_t.
+ *
+ * Note that the elems themselves are not freed.
+ *
+ * @param depot: an instance of dzf_depot_t.
+ * @return none
+ */
+DZF_PUBLIC
+static inline void
+dzf_depot_data_free(dzf_depot_t *depot)
+{
+    __die(depot);
+
+    __dzf_depot_data_free(depot);
+}
+
+/*!
+ * Initialize a dzf_mag_cache_t(T) instance on a depot.
+ *
+ * @param self: an instance of dzf_mag_cache_t(T).
+ * @param depot: a dzf_depot_t of T.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+#define dzf_mag_cache_init(self, depot) \
+    ( \
+      __die(self), \
+      __die(depot), \
+      __die(sizeof(*(self)->loaded->data) == __dzf_base_get_elem_size(depot)), \
+      __dzf_mag_cache_init(self, depot) \
+    )
+
+/*!
+ * Give the magazines of dzf_mag_cache_t(T) back to its depot.
+ *
+ * The cache may be used again after 'dzf_mag_cache_init'.
+ *
+ * @param self: an instance of dzf_mag_cache_t(T).
+ * @return none
+ */
+DZF_PUBLIC
+static inline void
+dzf_mag_cache_flush(void *self)
+{
+    __die(self);
+
+    __dzf_mag_cache_flush(self);
+}
+
+/*!
+ * Push a value through dzf_mag_cache_t(T).
+ *
+ * @param self: an instance of dzf_mag_cache_t(T).
+ * @param _val: a new value.
+ * @return none
+ */
+DZF_PUBLIC
+#define dzf_mag_cache_push(self, _val) \
+    ( \
+      __die(self), \
+      __dzf_mag_cache_is_full(self) \
+        ? (__dzf_mag_cache_make_room(self), 0) : 0, \
+      __dzf_stack_push((self)->loaded, _val) \
+    )
+
+/*!
+ * Try to pop a value through dzf_mag_cache_t(T).
+ *
+ * @param self: an instance of dzf_mag_cache_t(T).
+ * @param out: a pointer to T that receives the value.
+ * @return TRUE on success, FALSE if neither the cache nor the depot
+ *         has any.
+ */
+DZF_PUBLIC
+#define dzf_mag_cache_try_pop(self, out) \
+    ( \
+      __die(self), \
+      __dzf_stack_is_empty((self)->loaded) \
+        && !__dzf_mag_cache_refill(self) \
+        ? FALSE \
+        : (*(out) = __dzf_stack_pop((self)->loaded), TRUE) \
+    )
+
+#endif /* DZF_MAGAZINE_H */
@@ -0,0 +1,251 @@
+/* dzf-mpmc-queue-priv.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef DZF_MPMC_QUEUE_PRIV_H
+#define DZF_MPMC_QUEUE_PRIV_H
+
+#if !defined (DZF_MPMC_QUEUE_USE_AS_PRIVATE)
+#   error "Only <dzf/dzf-mpmc-queue.h> can be included directly!"
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#include "dzf-util.h"
+
+#define DZF_BASE_USE_AS_PRIVATE
+#include "dzf-base.h"
+#undef  DZF_BASE_USE_AS_PRIVATE
+
+/* -- Type Definition -- */
+/*!
+ * @def dzf_mpmc_queue_t(T)
+ * @brief Multi-producer/multi-consumer bounded queue type
+ *
+ * @param T: type that represents an elem of 'data' array.
+ *
+ * Every bucket of 'data' has its own sequence number in 'seqs' that
+ * tells whether it is ready to be written or read for a given lap,
+ * and producers/consumers claim positions by CAS on their own cache line.
+ *
+ * \b Examples
+ * @code{.c}
+ *   typedef dzf_mpmc_queue_t(long) mpmc_long_t;
+ *   typedef dzf_mpmc_queue_t(struct job *) mpmc_job_t;
+ * @endcode
+ */
+#define dzf_mpmc_queue_t(T) \
+    struct { \
+        __dzf_base_t _unused1; \
+        T *data; \
+        atomic_size_t *seqs; \
+        _Alignas(DZF_CACHELINE_SIZE) atomic_size_t enq_pos; \
+        _Alignas(DZF_CACHELINE_SIZE) atomic_size_t deq_pos; \
+    }
+
+typedef dzf_mpmc_queue_t(void*)     __dzf_mpmc_queue_priv_void_t;
+#define DZF_MPMC_QUEUE_VOID(self)   ((__dzf_mpmc_queue_priv_void_t*)self)
+
+#define DZF_MPMC_QUEUE_ALLOC_SIZE 1024 /* default capacity, must be a power of two */
+
+
+/* -- Private APIs -- */
+DZF_PRIVATE
+static inline size_t
+__dzf_mpmc_queue_capacity(void *self)
+{
+    return __dzf_base_get_capacity(self);
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_mpmc_queue_elem_size(void *self)
+{
+    return __dzf_base_get_elem_size(self);
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_mpmc_queue_mask(void *self)
+{
+    /* capacity is always a power of two */
+    return __dzf_mpmc_queue_capacity(self) - 1;
+}
+
+
+DZF_PRIVATE
+static inline void *
+__dzf_mpmc_queue_get_ptr_at(void *self,
+                            size_t index)
+{
+    __dzf_mpmc_queue_priv_void_t *q = self;
+
+    return (char *)q->data + index * __dzf_mpmc_queue_elem_size(q);
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_mpmc_queue_size(void *self)
+{
+    __dzf_mpmc_queue_priv_void_t *q = self;
+    size_t deq = atomic_load_explicit(&q->deq_pos, memory_order_acquire);
+    size_t enq = atomic_load_explicit(&q->enq_pos, memory_order_acquire);
+
+    /* a snapshot, positions may be claimed but not filled yet */
+    return ((ptrdiff_t)(enq - deq) > 0) ? enq - deq : 0;
+}
+
+
+DZF_PRIVATE
+static inline Bool
+__dzf_mpmc_queue_try_enq(void *self,
+                         const void *value)
+{
+    __dzf_mpmc_queue_priv_void_t *q = self;
+    size_t pos = atomic_load_explicit(&q->enq_pos, memory_order_relaxed);
+    size_t idx, seq;
+    intptr_t diff;
+
+    for (;;) {
+        idx = pos & __dzf_mpmc_queue_mask(q);
+        seq = atomic_load_explicit(&q->seqs[idx], memory_order_acquire);
+        diff = (intptr_t)seq - (intptr_t)pos;
+
+        if (diff == 0) {
+            /* the bucket is free in this lap, try to claim it */
+            if (atomic_compare_exchange_weak_explicit(&q->enq_pos,
+                                                      &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            /* the bucket is not consumed yet from the previous lap */
+            return FALSE;
+        } else {
+            /* another producer took it, catch up */
+            pos = atomic_load_explicit(&q->enq_pos, memory_order_relaxed);
+        }
+    }
+
+    memcpy(__dzf_mpmc_queue_get_ptr_at(q, idx), value,
+           __dzf_mpmc_queue_elem_size(q));
+    atomic_store_explicit(&q->seqs[idx], pos + 1, memory_order_release);
+
+    return TRUE;
+}
+
+
+DZF_PRIVATE
+static inline Bool
+__dzf_mpmc_queue_try_deq(void *self,
+                         void *out)
+{
+    __dzf_mpmc_queue_priv_void_t *q = self;
+    size_t pos = atomic_load_explicit(&q->deq_pos, memory_order_relaxed);
+    size_t idx, seq;
+    intptr_t diff;
+
+    for (;;) {
+        idx = pos & __dzf_mpmc_queue_mask(q);
+        seq = atomic_load_explicit(&q->seqs[idx], memory_order_acquire);
+        diff = (intptr_t)seq - (intptr_t)(pos + 1);
+
+        if (diff == 0) {
+            /* the bucket is filled in this lap, try to claim it */
+            if (atomic_compare_exchange_weak_explicit(&q->deq_pos,
+                                                      &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            /* the bucket is not produced yet in this lap */
+            return FALSE;
+        } else {
+            /* another consumer took it, catch up */
+            pos = atomic_load_explicit(&q->deq_pos, memory_order_relaxed);
+        }
+    }
+
+    memcpy(out, __dzf_mpmc_queue_get_ptr_at(q, idx),
+           __dzf_mpmc_queue_elem_size(q));
+    /* hand the bucket over to the producers of the next lap */
+    atomic_store_explicit(&q->seqs[idx], pos + __dzf_mpmc_queue_capacity(q),
+                          memory_order_release);
+
+    return TRUE;
+}
+
+
+DZF_PRIVATE
+static inline int
+__dzf_mpmc_queue_init(void *self,
+                      size_t elem_size, size_t capacity)
+{
+    __dzf_mpmc_queue_priv_void_t *q = self;
+    size_t i;
+
+    if (capacity <= DZF_MPMC_QUEUE_ALLOC_SIZE)
+        capacity = DZF_MPMC_QUEUE_ALLOC_SIZE;
+    capacity = dzf_next_pow2(capacity);
+
+    __dzf_base_init(q, 0, capacity, elem_size);
+    q->data = (void **)__dzf_base_alloc_array(q, capacity, elem_size);
+    q->seqs = __dzf_base_alloc_array(q, capacity, sizeof(atomic_size_t));
+    for (i = 0; i < capacity; i++)
+        atomic_init(&q->seqs[i], i);
+    atomic_init(&q->enq_pos, 0);
+    atomic_init(&q->deq_pos, 0);
+
+    return 0;
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_mpmc_queue_data_free(void *self)
+{
+    __dzf_mpmc_queue_priv_void_t *q = self;
+
+    if (q->data != NULL) {
+        __dzf_base_free_array(q, q->data,
+                              __dzf_mpmc_queue_capacity(q),
+                              __dzf_mpmc_queue_elem_size(q));
+        q->data = NULL;
+    }
+    if (q->seqs != NULL) {
+        __dzf_base_free_array(q, q->seqs,
+                              __dzf_mpmc_queue_capacity(q),
+                              sizeof(atomic_size_t));
+        q->seqs = NULL;
+    }
+    __dzf_base_init(q, 0, 0, 0);
+    atomic_init(&q->enq_pos, 0);
+    atomic_init(&q->deq_pos, 0);
+}
+
+#endif /* DZF_MPMC_QUEUE_PRIV_H */
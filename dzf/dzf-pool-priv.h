@@ -0,0 +1,220 @@
+/* dzf-pool-priv.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef DZF_POOL_PRIV_H
+#define DZF_POOL_PRIV_H
+
+#if !defined (DZF_POOL_USE_AS_PRIVATE)
+#   error "Only <dzf/dzf-pool.h> can be included directly!"
+#endif
+
+#include <stdint.h>
+
+#include "dzf-util.h"
+
+#define DZF_BASE_USE_AS_PRIVATE
+#include "dzf-base.h"
+#undef  DZF_BASE_USE_AS_PRIVATE
+
+/* -- Type Definition -- */
+/*!
+ * @def dzf_pool_t(T)
+ * @brief Fixed-size object pool type
+ *
+ * @param T: type of objects that the pool hands out.
+ *
+ * Objects are carved out of slabs whose first slot is aligned to
+ * 'DZF_CACHELINE_SIZE'. A freed slot holds the link to the next free
+ * one in itself, so that the free-list costs no memory.
+ *
+ * \b Examples
+ * @code{.c}
+ *   typedef dzf_pool_t(struct node) pool_node_t;
+ * @endcode
+ */
+#define dzf_pool_t(T) \
+    struct { \
+        __dzf_base_t _unused1; \
+        void *free_list; \
+        char *bump; \
+        char *bump_end; \
+        void *slabs; \
+        size_t slab_size; \
+        T *hold_elem; \
+    }
+
+typedef dzf_pool_t(void)     __dzf_pool_priv_void_t;
+#define DZF_POOL_VOID(self)  ((__dzf_pool_priv_void_t*)self)
+
+#define DZF_POOL_ALLOC_SIZE 64 /* default number of slots per slab */
+
+typedef struct __dzf_pool_slab {
+    struct __dzf_pool_slab *next;
+    size_t bytes;   /* whole slab including this header */
+} __dzf_pool_slab_t;
+
+
+/* -- Private APIs -- */
+DZF_PRIVATE
+static inline size_t
+__dzf_pool_elem_size(void *self)
+{
+    return __dzf_base_get_elem_size(self);
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_pool_size(void *self)
+{
+    return __dzf_base_get_length(self);
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_pool_capacity(void *self)
+{
+    return __dzf_base_get_capacity(self);
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_pool_slot_size(size_t elem_size)
+{
+    /* room for the free-list link, and keeps the alignment of T */
+    if (elem_size < sizeof(void *))
+        elem_size = sizeof(void *);
+
+    return (elem_size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_pool_add_slab(void *self)
+{
+    __dzf_pool_priv_void_t *pool = self;
+    size_t slot_size = __dzf_pool_elem_size(pool);
+    size_t bytes, header;
+    __dzf_pool_slab_t *slab;
+    uintptr_t slots;
+
+    /* the header and padding up to the cache line boundary come first */
+    header = sizeof(__dzf_pool_slab_t) + DZF_CACHELINE_SIZE - 1;
+    bytes = header + dzf_mul_size(pool->slab_size, slot_size);
+
+    slab = __dzf_base_alloc_array(pool, bytes, 1);
+    slab->next = pool->slabs;
+    slab->bytes = bytes;
+    pool->slabs = slab;
+
+    slots = (uintptr_t)(slab + 1);
+    slots = (slots + DZF_CACHELINE_SIZE - 1) & ~(uintptr_t)(DZF_CACHELINE_SIZE - 1);
+
+    pool->bump = (char *)slots;
+    pool->bump_end = pool->bump + pool->slab_size * slot_size;
+    __dzf_base_set_capacity(pool, __dzf_pool_capacity(pool) + pool->slab_size);
+}
+
+
+DZF_PRIVATE
+static inline void *
+__dzf_pool_alloc(void *self)
+{
+    __dzf_pool_priv_void_t *pool = self;
+    void *slot;
+
+    if (pool->free_list) {
+        /* pop the free-list, the link is in the slot itself */
+        slot = pool->free_list;
+        pool->free_list = *(void **)slot;
+    } else {
+        /* carve the latest slab lazily, grow by a whole one if used up */
+        if (pool->bump == pool->bump_end)
+            __dzf_pool_add_slab(pool);
+        slot = pool->bump;
+        pool->bump += __dzf_pool_elem_size(pool);
+    }
+    __dzf_base_set_length(pool, __dzf_pool_size(pool) + 1);
+
+    return slot;
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_pool_free(void *self,
+                void *slot)
+{
+    __dzf_pool_priv_void_t *pool = self;
+
+    *(void **)slot = pool->free_list;
+    pool->free_list = slot;
+    __dzf_base_set_length(pool, __dzf_pool_size(pool) - 1);
+}
+
+
+DZF_PRIVATE
+static inline int
+__dzf_pool_init(void *self,
+                size_t elem_size, size_t slab_size,
+                const dzf_allocator_t *allocator)
+{
+    __dzf_pool_priv_void_t *pool = self;
+
+    if (slab_size < 1)
+        slab_size = DZF_POOL_ALLOC_SIZE;
+
+    memset(pool, 0, sizeof(*pool));
+
+    __dzf_base_init(pool, 0, 0, __dzf_pool_slot_size(elem_size));
+    if (allocator)
+        __dzf_base_set_allocator(pool, allocator);
+    pool->slab_size = slab_size;
+
+    return 0;
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_pool_data_free(void *self)
+{
+    __dzf_pool_priv_void_t *pool = self;
+    __dzf_pool_slab_t *slab, *next;
+
+    for (slab = pool->slabs; slab; slab = next) {
+        next = slab->next;
+        __dzf_base_free_array(pool, slab, slab->bytes, 1);
+    }
+    __dzf_base_init(pool, 0, 0, 0);
+    pool->free_list = NULL;
+    pool->bump = NULL;
+    pool->bump_end = NULL;
+    pool->slabs = NULL;
+}
+
+#endif /* DZF_POOL_PRIV_H */
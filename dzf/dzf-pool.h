@@ -0,0 +1,191 @@
+/* dzf-pool.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! @file dzf-pool.h
+ *
+ * @brief Fixed-Size Object Pool (Slab Allocator).
+ *
+ * dzf_pool_t(T) hands out objects of T one by one, and takes them back
+ * in any order. Default slab is '64' objects unless clarify it via
+ * initializer, and the pool grows by a whole slab once it runs out.
+ *
+ * Allocating pops the free-list or bumps a pointer in the latest slab,
+ * freeing pushes the free-list, hence both are a couple of instructions.
+ * The slabs are given back only when the pool itself is freed.
+ *
+ * \b Examples
+ * @code{.c}
+ *   dzf_pool_t(struct node) pool;
+ *   struct node *n;
+ *
+ *   dzf_pool_new(&pool, sizeof(struct node));
+ *   n = dzf_pool_alloc(&pool);
+ *   ...
+ *   dzf_pool_release(&pool, n);
+ *   dzf_pool_data_free(&pool);
+ * @endcode
+ */
+
+#ifndef DZF_POOL_H
+#define DZF_POOL_H
+
+#define DZF_POOL_USE_AS_PRIVATE
+#include "dzf-pool-priv.h"
+
+
+/*!
+ * Initialize a dzf_pool_t(T) instance.
+ *
+ * No slab is allocated until the first object is requested.
+ *
+ * @param self: an instance of dzf_pool_t(T).
+ * @param elem_size: size of T in byte unit.
+ * @param slab_size: number of objects per slab.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_pool_init(void *self,
+              size_t elem_size, size_t slab_size)
+{
+    __die(self);
+
+    return __dzf_pool_init(self, elem_size, slab_size, NULL);
+}
+
+/*!
+ * Initialize a dzf_pool_t(T) instance with slab size '64'.
+ *
+ * @param self: an instance of dzf_pool_t(T).
+ * @param elem_size: size of T in byte unit.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_pool_new(void *self,
+             size_t elem_size)
+{
+    __die(self);
+
+    return __dzf_pool_init(self, elem_size, DZF_POOL_ALLOC_SIZE, NULL);
+}
+
+/*!
+ * Initialize a dzf_pool_t(T) instance whose slabs come from the allocator.
+ *
+ * @param self: an instance of dzf_pool_t(T).
+ * @param elem_size: size of T in byte unit.
+ * @param slab_size: number of objects per slab.
+ * @param allocator: an allocator that outlives the pool, NULL for default.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_pool_init_with_allocator(void *self,
+                             size_t elem_size, size_t slab_size,
+                             const dzf_allocator_t *allocator)
+{
+    __die(self);
+
+    return __dzf_pool_init(self, elem_size, slab_size, allocator);
+}
+
+/*!
+ * Free every slab of dzf_pool_t(T), including objects in use.
+ * Note that it doesn't free pool itself if from malloc.
+ *
+ * @param self: an instance of dzf_pool_t(T).
+ * @return none
+ */
+DZF_PUBLIC
+static inline void
+dzf_pool_data_free(void *self)
+{
+    __die(self);
+
+    __dzf_pool_data_free(self);
+}
+
+/*!
+ * Get the number of objects in use of dzf_pool_t(T).
+ *
+ * @param self: an instance of dzf_pool_t(T).
+ * @return the number of objects in use.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_pool_size(void *self)
+{
+    __die(self);
+
+    return __dzf_pool_size(self);
+}
+
+/*!
+ * Get the number of objects that all slabs of dzf_pool_t(T) hold.
+ *
+ * @param self: an instance of dzf_pool_t(T).
+ * @return the capacity.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_pool_capacity(void *self)
+{
+    __die(self);
+
+    return __dzf_pool_capacity(self);
+}
+
+/*!
+ * Allocate an object from dzf_pool_t(T).
+ *
+ * Note that the object is not initialized.
+ *
+ * @param self: an instance of dzf_pool_t(T).
+ * @return a pointer to T.
+ */
+DZF_PUBLIC
+#define dzf_pool_alloc(self) \
+    ( \
+      __die(self), \
+      (self)->hold_elem = __dzf_pool_alloc(self), \
+      (self)->hold_elem \
+    )
+
+/*!
+ * Give an object back to dzf_pool_t(T).
+ *
+ * @param self: an instance of dzf_pool_t(T).
+ * @param ptr: a pointer to T from the same pool.
+ * @return none
+ */
+DZF_PUBLIC
+#define dzf_pool_release(self, ptr) \
+    ( \
+      __die(self), \
+      __die(ptr), \
+      __dzf_pool_free(self, ptr) \
+    )
+
+#endif /* DZF_POOL_H */
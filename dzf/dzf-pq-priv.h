@@ -0,0 +1,263 @@
+/* dzf-pq-priv.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef DZF_PQ_PRIV_H
+#define DZF_PQ_PRIV_H
+
+#if !defined(DZF_PQ_USE_AS_PRIVATE)
+#   error "Only <dzf/dzf-pq.h> can be included directly!"
+#endif
+
+#define DZF_VEC_USE_AS_PRIVATE
+#include "dzf-vector-priv.h"
+#undef  DZF_VEC_USE_AS_PRIVATE
+
+typedef int (*__dzf_pq_cmp_fn)(const void *a, const void *b);
+
+/* -- Type Definition -- */
+/*!
+ * @def dzf_pq_t(T)
+ * @brief Priority queue type
+ *
+ * @param T: type that represents an elem of 'data' array.
+ *
+ * 'data' is an implicit d-ary heap laid out like dzf_vec_t(T), children
+ * of the elem at 'i' are at 'arity * i + 1' on. It starts the same as
+ * dzf_vec_t(T), so that the vector APIs manage its buckets.
+ *
+ * \b Examples
+ * @code{.c}
+ *   typedef dzf_pq_t(int) pq_int_t;
+ *   typedef dzf_pq_t(struct _task) pq_task_t;
+ * @endcode
+ */
+#define dzf_pq_t(T) \
+    struct { \
+        __dzf_base_t _unused1; \
+        T *data; \
+        __dzf_pq_cmp_fn cmp; \
+        size_t arity; \
+        T hold_elem; \
+    }
+
+typedef dzf_pq_t(char) __dzf_pq_priv_void_t;
+#define DZF_PQ_VOID(self) ((__dzf_pq_priv_void_t*)self)
+
+#define DZF_PQ_ALLOC_SIZE 16 /* default capacity */
+
+/* compile-time default, e.g. -DDZF_PQ_ARITY=2 for a binary heap */
+#if !defined(DZF_PQ_ARITY)
+#   define DZF_PQ_ARITY 4
+#endif
+
+
+/* -- Private APIs -- */
+DZF_PRIVATE
+static inline size_t
+__dzf_pq_size(void *self)
+{
+    return __dzf_vec_get_length(self);
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_pq_elem_size(void *self)
+{
+    return __dzf_vec_get_elem_size(self);
+}
+
+
+DZF_PRIVATE
+static inline void *
+__dzf_pq_get_ptr_at(void *self,
+                    size_t index)
+{
+    __dzf_pq_priv_void_t *pq = self;
+
+    return pq->data + index * __dzf_pq_elem_size(pq);
+}
+
+
+/* move parents down from the hole at 'index', then drop 'elem' in */
+DZF_PRIVATE
+static inline void
+__dzf_pq_sift_up(void *self,
+                 size_t index, const void *elem)
+{
+    __dzf_pq_priv_void_t *pq = self;
+    size_t es = __dzf_pq_elem_size(pq);
+    size_t parent;
+
+    while (index > 0) {
+        parent = (index - 1) / pq->arity;
+        if (pq->cmp(elem, __dzf_pq_get_ptr_at(pq, parent)) >= 0)
+            break;
+        memcpy(__dzf_pq_get_ptr_at(pq, index),
+               __dzf_pq_get_ptr_at(pq, parent), es);
+        index = parent;
+    }
+    memcpy(__dzf_pq_get_ptr_at(pq, index), elem, es);
+}
+
+
+/*
+ * Move the least children up from the hole at 'index' among the first
+ * 'length' elems, then drop 'elem' in. 'elem' must not lie within them.
+ */
+DZF_PRIVATE
+static inline void
+__dzf_pq_sift_down(void *self,
+                   size_t index, size_t length, const void *elem)
+{
+    __dzf_pq_priv_void_t *pq = self;
+    size_t es = __dzf_pq_elem_size(pq);
+    size_t child, last, best, c;
+
+    for (;;) {
+        child = pq->arity * index + 1;
+        if (child >= length)
+            break;
+
+        /* the children are adjacent, a single cache line for small T */
+        last = child + pq->arity < length ? child + pq->arity : length;
+        best = child;
+        for (c = child + 1; c < last; c++)
+            if (pq->cmp(__dzf_pq_get_ptr_at(pq, c),
+                        __dzf_pq_get_ptr_at(pq, best)) < 0)
+                best = c;
+
+        if (pq->cmp(__dzf_pq_get_ptr_at(pq, best), elem) >= 0)
+            break;
+        memcpy(__dzf_pq_get_ptr_at(pq, index),
+               __dzf_pq_get_ptr_at(pq, best), es);
+        index = best;
+    }
+    memcpy(__dzf_pq_get_ptr_at(pq, index), elem, es);
+}
+
+
+/* Floyd's bottom-up construction, O(n) */
+DZF_PRIVATE
+static inline void
+__dzf_pq_heapify(void *self,
+                 void *scratch)
+{
+    __dzf_pq_priv_void_t *pq = self;
+    size_t length = __dzf_pq_size(pq);
+    size_t i;
+
+    if (length < 2)
+        return;
+
+    for (i = (length - 2) / pq->arity + 1; i-- > 0; ) {
+        memcpy(scratch, __dzf_pq_get_ptr_at(pq, i), __dzf_pq_elem_size(pq));
+        __dzf_pq_sift_down(pq, i, length, scratch);
+    }
+}
+
+
+DZF_PRIVATE
+static inline int
+__dzf_pq_init(void *self,
+              size_t elem_size, size_t capacity, __dzf_pq_cmp_fn cmp,
+              const dzf_allocator_t *allocator)
+{
+    __dzf_pq_priv_void_t *pq = self;
+
+    if (capacity <= DZF_PQ_ALLOC_SIZE)
+        capacity = DZF_PQ_ALLOC_SIZE;
+
+    __dzf_vec_init(pq, elem_size, capacity, allocator);
+    pq->cmp = cmp;
+    pq->arity = DZF_PQ_ARITY;
+
+    return 0;
+}
+
+
+/* take over the buckets of a dzf_vec_t(T), leaving it empty */
+DZF_PRIVATE
+static inline int
+__dzf_pq_init_from_vec(void *self,
+                       void *vec, __dzf_pq_cmp_fn cmp, void *scratch)
+{
+    __dzf_pq_priv_void_t *pq = self;
+
+    memcpy(pq, vec, sizeof(__dzf_vec_priv_void_t));
+    memset(vec, 0, sizeof(__dzf_vec_priv_void_t));
+    pq->cmp = cmp;
+    pq->arity = DZF_PQ_ARITY;
+    __dzf_pq_heapify(pq, scratch);
+
+    return 0;
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_pq_set_arity(void *self,
+                   size_t arity, void *scratch)
+{
+    __dzf_pq_priv_void_t *pq = self;
+
+    __die(arity >= 2);
+
+    if (pq->arity != arity) {
+        pq->arity = arity;
+        __dzf_pq_heapify(pq, scratch);
+    }
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_pq_push(void *self,
+              const void *elem)
+{
+    size_t length = __dzf_pq_size(self);
+
+    if (__dzf_vec_is_full(self))
+        __dzf_vec_try_growing(self);
+
+    __dzf_pq_sift_up(self, length, elem);
+    __dzf_vec_set_length(self, length + 1);
+}
+
+
+/* copy the top into 'out', then refill the root with the last elem */
+DZF_PRIVATE
+static inline void
+__dzf_pq_pop(void *self,
+             void *out)
+{
+    size_t length = __dzf_pq_size(self) - 1;
+
+    memcpy(out, __dzf_pq_get_ptr_at(self, 0), __dzf_pq_elem_size(self));
+    if (length > 0)
+        __dzf_pq_sift_down(self, 0, length, __dzf_pq_get_ptr_at(self, length));
+    __dzf_vec_set_length(self, length);
+}
+
+#endif /* DZF_PQ_PRIV_H */
@@ -0,0 +1,279 @@
+/* dzf-pq.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! @file dzf-pq.h
+ *
+ * @brief Priority Queue Type Structure.
+ *
+ * dzf_pq_t(T) always gives the least elem first, ordered by a comparator
+ * in the form of qsort(3), e.g. invert it for the greatest one first.
+ * Default capacity is '16' unless clarify it via initializer, and the
+ * buckets grow in the same way as dzf_vec_t(T).
+ *
+ * It is a d-ary heap, 4-ary by default. A wider heap is shallower and
+ * keeps the children of an elem side by side, which costs fewer cache
+ * misses than a binary heap. Define 'DZF_PQ_ARITY' or use
+ * 'dzf_pq_set_arity' to change it.
+ *
+ * \b Examples
+ * @code{.c}
+ *   dzf_pq_t(int) pq;
+ *
+ *   dzf_pq_new(&pq, sizeof(int), cmp_int);
+ *   dzf_pq_push(&pq, 3);
+ *   dzf_pq_push(&pq, 1);
+ *   printf("%d\n", dzf_pq_pop(&pq));  // 1
+ *   dzf_pq_data_free(&pq);
+ * @endcode
+ */
+
+#ifndef DZF_PQ_H
+#define DZF_PQ_H
+
+#define DZF_PQ_USE_AS_PRIVATE
+#include "dzf-pq-priv.h"
+
+
+/*!
+ * Initialize a dzf_pq_t(T) instance whose buckets come from the allocator.
+ *
+ * @param self: an instance of dzf_pq_t(T).
+ * @param elem_size: each element size in byte unit.
+ * @param capacity: number of elements in the queue.
+ * @param cmp: a comparator of pointers to T, in the form of qsort(3).
+ * @param allocator: an allocator that outlives the queue, NULL for default.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_pq_init_with_allocator(void *self,
+                           size_t elem_size, size_t capacity,
+                           __dzf_pq_cmp_fn cmp,
+                           const dzf_allocator_t *allocator)
+{
+    __die(self);
+    __die(cmp);
+
+    return __dzf_pq_init(self, elem_size, capacity, cmp, allocator);
+}
+
+/*!
+ * Initialize a dzf_pq_t(T) instance.
+ *
+ * @param self: an instance of dzf_pq_t(T).
+ * @param elem_size: each element size in byte unit.
+ * @param capacity: number of elements in the queue.
+ * @param cmp: a comparator of pointers to T, in the form of qsort(3).
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_pq_init(void *self,
+            size_t elem_size, size_t capacity, __dzf_pq_cmp_fn cmp)
+{
+    __die(self);
+    __die(cmp);
+
+    return __dzf_pq_init(self, elem_size, capacity, cmp, NULL);
+}
+
+/*!
+ * Initialize a dzf_pq_t(T) instance with capacity '16'.
+ *
+ * @param self: an instance of dzf_pq_t(T).
+ * @param elem_size: each element size in byte unit.
+ * @param cmp: a comparator of pointers to T, in the form of qsort(3).
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_pq_new(void *self,
+           size_t elem_size, __dzf_pq_cmp_fn cmp)
+{
+    __die(self);
+    __die(cmp);
+
+    return __dzf_pq_init(self, elem_size, DZF_PQ_ALLOC_SIZE, cmp, NULL);
+}
+
+/*!
+ * Initialize a dzf_pq_t(T) instance with the elems of a dzf_vec_t(T).
+ *
+ * The queue takes over the buckets of the vector in O(n) without
+ * copying, and the vector is left empty with no buckets.
+ *
+ * @param self: an instance of dzf_pq_t(T).
+ * @param vec: an instance of dzf_vec_t(T).
+ * @param cmp: a comparator of pointers to T, in the form of qsort(3).
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+#define dzf_pq_init_from_vec(self, vec, cmp) \
+    ( \
+      __die(self), \
+      __die(vec), \
+      __die(cmp), \
+      __dzf_pq_init_from_vec(self, vec, cmp, &(self)->hold_elem) \
+    )
+
+/*!
+ * Free buckets of dzf_pq_t(T).
+ *
+ * @param self: an instance of dzf_pq_t(T).
+ * @return none
+ */
+DZF_PUBLIC
+static inline void
+dzf_pq_data_free(void *self)
+{
+    __die(self);
+
+    __dzf_vec_data_free(self);
+}
+
+/*!
+ * Set the number of children per elem of dzf_pq_t(T).
+ *
+ * The elems are rearranged in O(n) if the arity changes.
+ *
+ * @param self: an instance of dzf_pq_t(T).
+ * @param arity: number of children per elem, at least 2.
+ * @return none
+ */
+DZF_PUBLIC
+#define dzf_pq_set_arity(self, arity) \
+    ( \
+      __die(self), \
+      __dzf_pq_set_arity(self, arity, &(self)->hold_elem) \
+    )
+
+/*!
+ * Get the number of children per elem of dzf_pq_t(T).
+ *
+ * @param self: an instance of dzf_pq_t(T).
+ * @return the arity.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_pq_get_arity(void *self)
+{
+    __die(self);
+
+    return DZF_PQ_VOID(self)->arity;
+}
+
+/*!
+ * Get the number of elems in dzf_pq_t(T).
+ *
+ * @param self: an instance of dzf_pq_t(T).
+ * @return the number of elems.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_pq_size(void *self)
+{
+    __die(self);
+
+    return __dzf_pq_size(self);
+}
+
+/*!
+ * Get the capacity of dzf_pq_t(T).
+ *
+ * @param self: an instance of dzf_pq_t(T).
+ * @return the capacity.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_pq_capacity(void *self)
+{
+    __die(self);
+
+    return __dzf_vec_get_alloc_size(self);
+}
+
+/*!
+ * Is dzf_pq_t(T) empty?
+ *
+ * @param self: an instance of dzf_pq_t(T).
+ * @return TRUE if empty, otherwise FALSE.
+ */
+DZF_PUBLIC
+static inline Bool
+dzf_pq_is_empty(void *self)
+{
+    __die(self);
+
+    return (__dzf_pq_size(self) == 0 ? TRUE : FALSE);
+}
+
+/*!
+ * Push a value into dzf_pq_t(T), O(log n).
+ *
+ * @param self: an instance of dzf_pq_t(T).
+ * @param _val: a new value.
+ * @return none
+ */
+DZF_PUBLIC
+#define dzf_pq_push(self, _val) \
+    ( \
+      __die(self), \
+      (self)->hold_elem = (_val), \
+      __dzf_pq_push(self, &(self)->hold_elem) \
+    )
+
+/*!
+ * Pop the least value from dzf_pq_t(T), O(log n).
+ *
+ * Note that it dies if the queue is empty.
+ *
+ * @param self: an instance of dzf_pq_t(T).
+ * @return the least value.
+ */
+DZF_PUBLIC
+#define dzf_pq_pop(self) \
+    ( \
+      __die(self), \
+      __die(!__dzf_vec_is_empty(self)), \
+      __dzf_pq_pop(self, &(self)->hold_elem), \
+      (self)->hold_elem \
+    )
+
+/*!
+ * Get the least value of dzf_pq_t(T) without popping it.
+ *
+ * Note that it dies if the queue is empty.
+ *
+ * @param self: an instance of dzf_pq_t(T).
+ * @return the least value.
+ */
+DZF_PUBLIC
+#define dzf_pq_peek(self) \
+    ( \
+      __die(self), \
+      __die(!__dzf_vec_is_empty(self)), \
+      (self)->data[0] \
+    )
+
+#endif /* DZF_PQ_H */
@@ -53,16 +53,16 @@
 #define dzf_queue_t(T) \
     struct { \
         __dzf_base_t _unused1; \
-        int front; \
-        int rear; \
-        T hold_elem; \
+        size_t head; \
+        size_t tail; \
         T *data; \
+        T hold_elem; \
     }
 
 typedef dzf_queue_t(void*)       __dzf_queue_priv_void_t;
 #define DZF_QUEUE_VOID(self)   ((__dzf_queue_priv_void_t*)self)
 
-#define DZF_QUEUE_ALLOC_SIZE 16 /* default capacity */
+#define DZF_QUEUE_ALLOC_SIZE 16 /* default capacity, must be a power of two */
 
 
 /* -- Private APIs -- */
@@ -103,44 +103,40 @@ __dzf_queue_elem_size(void *self)
 
 
 DZF_PRIVATE
-static inline void
-__dzf_queue_set_front(void *self,
-                      int new_front)
+static inline size_t
+__dzf_queue_mask(void *self)
 {
-    __dzf_queue_priv_void_t *q = self;
-
-    q->front = new_front;
+    /* capacity is always a power of two */
+    return __dzf_queue_capacity(self) - 1;
 }
 
 
 DZF_PRIVATE
-static inline int
-__dzf_queue_front(void *self)
+static inline size_t
+__dzf_queue_head(void *self)
 {
     __dzf_queue_priv_void_t *q = self;
 
-    return q->front;
+    return q->head;
 }
 
 
 DZF_PRIVATE
-static inline void
-__dzf_queue_set_rear(void *self,
-                     int new_rear)
+static inline size_t
+__dzf_queue_tail(void *self)
 {
     __dzf_queue_priv_void_t *q = self;
 
-    q->rear = new_rear;
+    return q->tail;
 }
 
 
 DZF_PRIVATE
-static inline int
-__dzf_queue_rear(void *self)
+static inline size_t
+__dzf_queue_size(void *self)
 {
-    __dzf_queue_priv_void_t *q = self;
-
-    return q->rear;
+    /* well-defined even after the counters wrap around */
+    return __dzf_queue_tail(self) - __dzf_queue_head(self);
 }
 
 
@@ -148,60 +144,173 @@ DZF_PRIVATE
 static inline Bool
 __dzf_queue_is_empty(void *self)
 {
-    return (__dzf_queue_front(self) == -1) ? TRUE : FALSE;
+    return (__dzf_queue_size(self) == 0) ? TRUE : FALSE;
 }
 
 
 DZF_PRIVATE
 static inline Bool
 __dzf_queue_is_full(void *self)
+{
+    return (__dzf_queue_size(self) == __dzf_queue_capacity(self)) \
+           ? TRUE : FALSE;
+}
+
+
+DZF_PRIVATE
+static inline ptrdiff_t
+__dzf_queue_front(void *self)
 {
     if (__dzf_queue_is_empty(self))
-        return FALSE;
+        return -1;
 
-    /* '(rear + 1) % capacity == front' represents full */
-    return ( ((__dzf_queue_rear(self) + 1) % __dzf_queue_capacity(self)) \
-             == __dzf_queue_front(self) ) ? TRUE : FALSE;
+    return __dzf_queue_head(self) & __dzf_queue_mask(self);
 }
 
 
-/* called under early 'queue_is_full' */
 DZF_PRIVATE
-static inline void
-__dzf_queue_adjust_rear(void *self)
+static inline ptrdiff_t
+__dzf_queue_rear(void *self)
 {
-    int next_value = (__dzf_queue_rear(self) + 1) % \
-                     __dzf_queue_capacity(self);
+    if (__dzf_queue_is_empty(self))
+        return -1;
+
+    return (__dzf_queue_tail(self) - 1) & __dzf_queue_mask(self);
+}
 
-    __dzf_queue_set_rear(self, next_value);
 
-    if (__dzf_queue_front(self) == -1)
-        __dzf_queue_set_front(self, 0);
+DZF_PRIVATE
+static inline void *
+__dzf_queue_get_ptr_at(void *self,
+                       size_t index)
+{
+    __dzf_queue_priv_void_t *q = self;
+
+    return (char *)q->data + index * __dzf_queue_elem_size(q);
 }
 
 
-/* called under early 'queue_is_empty' */
 DZF_PRIVATE
-static inline void
-__dzf_queue_adjust_front(void *self)
+static inline Bool
+__dzf_queue_is_growable(void *self)
+{
+    return __dzf_base_has_flag(self, DZF_BASE_FLAG_GROWABLE);
+}
+
+
+DZF_PRIVATE
+static inline Bool
+__dzf_queue_is_borrowed(void *self)
+{
+    return __dzf_base_has_flag(self, DZF_BASE_FLAG_BORROWED);
+}
+
+
+/* copy the ring out of the borrowed buckets, linearized from 0 */
+DZF_PRIVATE
+static inline size_t
+__dzf_queue_unborrow(void *self,
+                     size_t new_size)
+{
+    __dzf_queue_priv_void_t *q = self;
+    size_t old_size = __dzf_queue_capacity(q);
+    size_t size = __dzf_queue_size(q);
+    size_t front = __dzf_queue_head(q) & __dzf_queue_mask(q);
+    size_t first = (front + size > old_size) ? old_size - front : size;
+    void *newm = __dzf_base_alloc_array(q, new_size,
+                                        __dzf_queue_elem_size(q));
+
+    memcpy(newm, __dzf_queue_get_ptr_at(q, front),
+           __dzf_queue_elem_size(q) * first);
+    memcpy((char *)newm + __dzf_queue_elem_size(q) * first,
+           __dzf_queue_get_ptr_at(q, 0),
+           __dzf_queue_elem_size(q) * (size - first));
+
+    q->data = newm;
+    q->head = 0;
+    q->tail = size;
+    __dzf_queue_set_capacity(q, new_size);
+    __dzf_base_toggle_flag(q, DZF_BASE_FLAG_BORROWED, FALSE);
+
+    return new_size;
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_queue_try_growing(void *self)
 {
-    int next_value = (__dzf_queue_front(self) + 1) % \
-                     __dzf_queue_capacity(self);
+    __dzf_queue_priv_void_t *q = self;
+    size_t old_size = __dzf_queue_capacity(q);
+    size_t new_size = old_size * 2;
+    size_t size = __dzf_queue_size(q);
+    size_t front = __dzf_queue_head(q) & __dzf_queue_mask(q);
+    size_t tail_len = old_size - front;             /* [front, old_size) */
+    size_t head_len = (front + size > old_size)     /* [0, wrapped rear] */
+                      ? front + size - old_size : 0;
+
+    if (!__dzf_queue_is_growable(q)) {
+        /* abort at runtime, not to corrupt current buckets */
+        __die(FALSE);
+        return 0;
+    }
 
-    if (__dzf_queue_front(self) == __dzf_queue_rear(self)) {
-        next_value = -1;
-        __dzf_queue_set_rear(self, next_value);
+    if (__dzf_queue_is_borrowed(q))
+        return __dzf_queue_unborrow(q, new_size);
+
+    q->data = __dzf_base_realloc_array(q, q->data, old_size, new_size,
+                                       __dzf_queue_elem_size(q));
+
+    /*
+     * Unless the elems are linear already, they are wrapped as
+     * [front, old_size) + [0, head_len), so move the shorter segment
+     * next to the other one with a single memcpy.
+     * The counters are relative, rebase them onto the new layout.
+     */
+    if (head_len <= tail_len) {
+        memcpy(__dzf_queue_get_ptr_at(q, old_size),
+               __dzf_queue_get_ptr_at(q, 0),
+               __dzf_queue_elem_size(q) * head_len);
+        q->head = front;
+    } else {
+        memcpy(__dzf_queue_get_ptr_at(q, new_size - tail_len),
+               __dzf_queue_get_ptr_at(q, front),
+               __dzf_queue_elem_size(q) * tail_len);
+        q->head = new_size - tail_len;
     }
+    q->tail = q->head + size;
+    __dzf_queue_set_capacity(q, new_size);
 
-    __dzf_queue_set_front(self, next_value);
+    return new_size;
+}
+
+
+/* called under early 'queue_is_full' */
+DZF_PRIVATE
+static inline size_t
+__dzf_queue_adjust_tail(void *self)
+{
+    __dzf_queue_priv_void_t *q = self;
+
+    return q->tail++ & __dzf_queue_mask(q);
+}
+
+
+/* called under early 'queue_is_empty' */
+DZF_PRIVATE
+static inline size_t
+__dzf_queue_adjust_head(void *self)
+{
+    __dzf_queue_priv_void_t *q = self;
+
+    return q->head++ & __dzf_queue_mask(q);
 }
 
 
 DZF_PRIVATE
 #define __dzf_queue_push_tail(self, value) \
     ( \
-      __dzf_queue_adjust_rear(self), \
-      (self)->data[__dzf_queue_rear(self)] = (value), \
+      (self)->data[__dzf_queue_adjust_tail(self)] = (value), \
       (void)0 /* represents success */ \
     )
 
@@ -209,26 +318,106 @@ DZF_PRIVATE
 DZF_PRIVATE
 #define __dzf_queue_pop_head(self) \
     ( \
-      (self)->hold_elem = (self)->data[__dzf_queue_front(self)], \
-      __dzf_queue_adjust_front(self), \
+      (self)->hold_elem = (self)->data[__dzf_queue_adjust_head(self)], \
       (self)->hold_elem \
     )
 
 
+/* copy 'n' elems at most in two chunks across the wrap point */
+DZF_PRIVATE
+static inline void
+__dzf_queue_push_tail_n(void *self,
+                        const void *src, size_t n)
+{
+    __dzf_queue_priv_void_t *q = self;
+    size_t elem_size = __dzf_queue_elem_size(q);
+    size_t rear = q->tail & __dzf_queue_mask(q);
+    size_t first = __dzf_queue_capacity(q) - rear;
+
+    if (first > n)
+        first = n;
+
+    memcpy(__dzf_queue_get_ptr_at(q, rear), src, elem_size * first);
+    memcpy(__dzf_queue_get_ptr_at(q, 0),
+           (const char *)src + elem_size * first, elem_size * (n - first));
+    q->tail += n;
+}
+
+
+/* copy 'n' elems at most in two chunks across the wrap point */
+DZF_PRIVATE
+static inline void
+__dzf_queue_pop_head_n(void *self,
+                       void *dst, size_t n)
+{
+    __dzf_queue_priv_void_t *q = self;
+    size_t elem_size = __dzf_queue_elem_size(q);
+    size_t front = q->head & __dzf_queue_mask(q);
+    size_t first = __dzf_queue_capacity(q) - front;
+
+    if (first > n)
+        first = n;
+
+    memcpy(dst, __dzf_queue_get_ptr_at(q, front), elem_size * first);
+    memcpy((char *)dst + elem_size * first,
+           __dzf_queue_get_ptr_at(q, 0), elem_size * (n - first));
+    q->head += n;
+}
+
+
 DZF_PRIVATE
 static inline int
-__dzf_queue_init(void *self,
-                 size_t elem_size, size_t capacity)
+__dzf_queue_init_aligned(void *self,
+                         size_t elem_size, size_t capacity,
+                         const dzf_allocator_t *allocator, size_t align)
 {
     __dzf_queue_priv_void_t *q = self;
 
     if (capacity <= DZF_QUEUE_ALLOC_SIZE)
         capacity = DZF_QUEUE_ALLOC_SIZE;
+    capacity = dzf_next_pow2(capacity);
+
+    __dzf_base_init(q, 0, capacity, elem_size);
+    if (allocator)
+        __dzf_base_set_allocator(q, allocator);
+    __dzf_base_set_align(q, align);
+    q->head = 0;
+    q->tail = 0;
+    q->data = (void **)__dzf_base_alloc_array(q, capacity, elem_size);
+
+    return 0;
+}
+
+
+DZF_PRIVATE
+static inline int
+__dzf_queue_init(void *self,
+                 size_t elem_size, size_t capacity,
+                 const dzf_allocator_t *allocator)
+{
+    return __dzf_queue_init_aligned(self, elem_size, capacity, allocator, 0);
+}
+
+
+/* 'buf' is borrowed until the queue outgrows it */
+DZF_PRIVATE
+static inline int
+__dzf_queue_init_with_buffer(void *self,
+                             size_t elem_size, void *buf, size_t capacity)
+{
+    __dzf_queue_priv_void_t *q = self;
+
+    __die(buf && capacity);
+
+    /* round down, the ring may only use a power of two of 'buf' */
+    while (capacity & (capacity - 1))
+        capacity &= capacity - 1;
 
     __dzf_base_init(q, 0, capacity, elem_size);
-    __dzf_queue_set_front(q, -1);
-    __dzf_queue_set_rear(q, -1);
-    q->data = (void **)dzf_malloc(elem_size * capacity);
+    __dzf_base_toggle_flag(q, DZF_BASE_FLAG_BORROWED, TRUE);
+    q->head = 0;
+    q->tail = 0;
+    q->data = buf;
 
     return 0;
 }
@@ -241,12 +430,15 @@ __dzf_queue_data_free(void *self)
     __dzf_queue_priv_void_t *q = self;
 
     if (q->data != NULL) {
-        free(q->data);
+        if (!__dzf_queue_is_borrowed(q))
+            __dzf_base_free_array(q, q->data,
+                                  __dzf_queue_capacity(q),
+                                  __dzf_queue_elem_size(q));
         q->data = NULL;
     }
     __dzf_base_init(q, 0, 0, 0);
-    __dzf_queue_set_front(q, -1);
-    __dzf_queue_set_rear(q, -1);
+    q->head = 0;
+    q->tail = 0;
 }
 
 #endif /* DZF_QUEUE_PRIV_H */
@@ -28,9 +28,15 @@
  *
  * Queue is an abstract data type that has a special characteristic.
  * FIFO, First In First Out. Default capacity is '16' unless clarify
- * the size via initializer.
+ * the size via initializer. The capacity is always rounded up to a power
+ * of two, so that the ring is indexed by masking its free running head
+ * and tail counters rather than modulo.
  *
- * dzf_queue_t(T) is based on circular queue type.
+ * dzf_queue_t(T) is based on circular queue type and provides two types,
+ * - \b Static: die on enqueue once it is full. (default)
+ * - \b Growable: grow up to the 'current capacity * 2' if full.
+ *
+ * Use 'dzf_queue_set_growable' to turn an instance into growable type.
  */
 
 #ifndef DZF_QUEUE_H
@@ -55,7 +61,72 @@ dzf_queue_init(void *self,
 {
     __die(self);
 
-    return __dzf_queue_init(self, elem_size, capacity);
+    return __dzf_queue_init(self, elem_size, capacity, NULL);
+}
+
+/*!
+ * Initialize a dzf_queue_t(T) instance whose buckets come from the allocator.
+ *
+ * @param self: an instance of dzf_queue_t(T).
+ * @param elem_size: each element size in byte unit.
+ * @param capacity: number of elements in the queue.
+ * @param allocator: an allocator that outlives the queue, NULL for default.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_queue_init_with_allocator(void *self,
+                              size_t elem_size, size_t capacity,
+                              const dzf_allocator_t *allocator)
+{
+    __die(self);
+
+    return __dzf_queue_init(self, elem_size, capacity, allocator);
+}
+
+/*!
+ * Initialize a dzf_queue_t(T) instance whose buckets start on an 'align'
+ * boundary, kept across growing.
+ *
+ * @param self: an instance of dzf_queue_t(T).
+ * @param elem_size: each element size in byte unit.
+ * @param capacity: number of elements in the queue.
+ * @param align: a power of two in byte unit, e.g. DZF_CACHELINE_SIZE.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_queue_init_aligned(void *self,
+                       size_t elem_size, size_t capacity, size_t align)
+{
+    __die(self);
+    __die(align && !(align & (align - 1)));
+
+    return __dzf_queue_init_aligned(self, elem_size, capacity, NULL,
+                                    align < sizeof(void *) ? sizeof(void *) : align);
+}
+
+/*!
+ * Initialize a dzf_queue_t(T) instance on caller-provided buckets.
+ *
+ * Nothing is allocated and 'buf' is never freed. Only the largest power
+ * of two buckets not exceeding 'capacity' are used. A growable queue
+ * copies its elems out to the heap once it outgrows 'buf'.
+ *
+ * @param self: an instance of dzf_queue_t(T).
+ * @param elem_size: each element size in byte unit.
+ * @param buf: buckets that outlive the queue, at least 'capacity' elems.
+ * @param capacity: number of elements 'buf' can hold, at least 1.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_queue_init_with_buffer(void *self,
+                           size_t elem_size, void *buf, size_t capacity)
+{
+    __die(self);
+
+    return __dzf_queue_init_with_buffer(self, elem_size, buf, capacity);
 }
 
 /*!
@@ -72,7 +143,7 @@ dzf_queue_new(void *self,
 {
     __die(self);
 
-    return __dzf_queue_init(self, elem_size, DZF_QUEUE_ALLOC_SIZE);
+    return __dzf_queue_init(self, elem_size, DZF_QUEUE_ALLOC_SIZE, NULL);
 }
 
 /*!
@@ -138,14 +209,29 @@ dzf_queue_capacity(void *self)
     return __dzf_queue_capacity(self);
 }
 
+/*!
+ * Get the number of elements in dzf_queue_t(T).
+ *
+ * @param self: an instance of dzf_queue_t(T).
+ * @return the number of elements.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_queue_size(void *self)
+{
+    __die(self);
+
+    return __dzf_queue_size(self);
+}
+
 /*!
  * Get the 'front' value of dzf_queue_t(T).
  *
  * @param self: an instance of dzf_queue_t(T).
- * @return the current front value.
+ * @return the bucket index of the front elem, -1 if empty.
  */
 DZF_PUBLIC
-static inline int
+static inline ptrdiff_t
 dzf_queue_front(void *self)
 {
     __die(self);
@@ -157,10 +243,10 @@ dzf_queue_front(void *self)
  * Get the 'rear' value of dzf_queue_t(T).
  *
  * @param self: an instance of dzf_queue_t(T).
- * @return the current rear value.
+ * @return the bucket index of the rear elem, -1 if empty.
  */
 DZF_PUBLIC
-static inline int
+static inline ptrdiff_t
 dzf_queue_rear(void *self)
 {
     __die(self);
@@ -168,6 +254,41 @@ dzf_queue_rear(void *self)
     return __dzf_queue_rear(self);
 }
 
+/*!
+ * Make dzf_queue_t(T) growable or not.
+ *
+ * A growable queue reallocates its buckets up to the 'current capacity * 2'
+ * on enqueue once it is full, instead of dying.
+ *
+ * @param self: an instance of dzf_queue_t(T).
+ * @param growable: TRUE to grow on full, FALSE to die on full.
+ * @return none
+ */
+DZF_PUBLIC
+static inline void
+dzf_queue_set_growable(void *self,
+                       Bool growable)
+{
+    __die(self);
+
+    __dzf_base_toggle_flag(self, DZF_BASE_FLAG_GROWABLE, growable);
+}
+
+/*!
+ * Is dzf_queue_t(T) growable?
+ *
+ * @param self: an instance of dzf_queue_t(T).
+ * @return TRUE if growable, otherwise FALSE.
+ */
+DZF_PUBLIC
+static inline Bool
+dzf_queue_is_growable(void *self)
+{
+    __die(self);
+
+    return __dzf_queue_is_growable(self);
+}
+
 /*!
  * Is dzf_queue_t(T) full?
  *
@@ -200,6 +321,8 @@ dzf_queue_is_empty(void *self)
 
 /*!
  * Enqueue a new value to the tail of dzf_queue_t(T).
+ *
+ * Note that it dies if full, unless the queue is growable.
  * 
  * @param self: an instance of dzf_queue_t(T).
  * @param val: a new value.
@@ -209,7 +332,7 @@ DZF_PUBLIC
 #define dzf_queue_enq(self, value) \
     ( \
       __die(self), \
-      __die(!__dzf_queue_is_full(self)), \
+      __dzf_queue_is_full(self) ? __dzf_queue_try_growing(self) : 0, \
       __dzf_queue_push_tail(self, value) \
     )
 
@@ -227,4 +350,63 @@ DZF_PUBLIC
       __dzf_queue_pop_head(self) \
     )
 
+/*!
+ * Enqueue 'n' values from an array to the tail of dzf_queue_t(T).
+ *
+ * The values are copied in at most two chunks across the end of the ring.
+ * Note that it dies if they don't fit, unless the queue is growable.
+ *
+ * @param self: an instance of dzf_queue_t(T).
+ * @param src: an array of T that holds 'n' values.
+ * @param n: number of values to enqueue.
+ * @return none
+ */
+DZF_PUBLIC
+static inline void
+dzf_queue_enq_n(void *self,
+                const void *src, size_t n)
+{
+    __die(self);
+    __die(src || n == 0);
+
+    /* nothing to copy, and memcpy from NULL is undefined even for 0 */
+    if (n == 0)
+        return;
+
+    while (__dzf_queue_capacity(self) - __dzf_queue_size(self) < n) {
+        if (!__dzf_queue_try_growing(self))
+            return;
+    }
+
+    __dzf_queue_push_tail_n(self, src, n);
+}
+
+/*!
+ * Dequeue up to 'n' values from the head of dzf_queue_t(T) to an array.
+ *
+ * The values are copied in at most two chunks across the end of the ring.
+ *
+ * @param self: an instance of dzf_queue_t(T).
+ * @param dst: an array of T that has room for 'n' values.
+ * @param n: maximum number of values to dequeue.
+ * @return number of values dequeued, less than 'n' if it runs out.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_queue_deq_n(void *self,
+                void *dst, size_t n)
+{
+    __die(self);
+    __die(dst || n == 0);
+
+    if (n > __dzf_queue_size(self))
+        n = __dzf_queue_size(self);
+    if (n == 0)
+        return 0;
+
+    __dzf_queue_pop_head_n(self, dst, n);
+
+    return n;
+}
+
 #endif /* DZF_QUEUE_H */
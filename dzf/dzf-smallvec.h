@@ -0,0 +1,100 @@
+/* dzf-smallvec.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! @file dzf-smallvec.h
+ *
+ * @brief Small-Buffer-Optimized Vector Type Structure.
+ *
+ * dzf_smallvec_t(T, N) is a dzf_vec_t(T) that keeps its first 'N'
+ * elements inline in the instance itself, so that short vectors never
+ * touch the heap. Once it outgrows them, the elements are copied out
+ * to the heap and it grows like any other vector from then on.
+ *
+ * Every dzf_vec_* API works on dzf_smallvec_t(T, N) as it is.
+ *
+ * Note that the instance must not be moved or copied by value, since
+ * 'data' points into itself while inline.
+ *
+ * \b Examples
+ * @code{.c}
+ *   typedef dzf_smallvec_t(int, 4) smallvec_int_t;
+ *   smallvec_int_t vec;
+ *
+ *   dzf_smallvec_new(&vec);
+ *   dzf_vec_add_tail(&vec, 1);
+ *   ...
+ *   dzf_vec_data_free(&vec);
+ * @endcode
+ */
+
+#ifndef DZF_SMALLVEC_H
+#define DZF_SMALLVEC_H
+
+#include "dzf-vector.h"
+
+/* -- Type Definition -- */
+/*!
+ * @def dzf_smallvec_t(T, N)
+ * @brief Small-buffer-optimized vector type
+ *
+ * @param T: type that represents an elem of 'data' array.
+ * @param N: number of elems kept inline, at least 1.
+ */
+#define dzf_smallvec_t(T, N) \
+    struct { \
+        __dzf_base_t _unused1; \
+        T *data; \
+        T inline_data[N]; \
+    }
+
+
+/*!
+ * Initialize a dzf_smallvec_t(T, N) instance on its inline buckets.
+ *
+ * @param self: an instance of dzf_smallvec_t(T, N).
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+#define dzf_smallvec_new(self) \
+    ( \
+      __die(self), \
+      __dzf_vec_init_with_buffer(self, sizeof((self)->inline_data[0]), \
+                                 (self)->inline_data, \
+                                 dzf_array_size((self)->inline_data)) \
+    )
+
+/*!
+ * Are the elems of dzf_smallvec_t(T, N) still inline?
+ *
+ * @param self: an instance of dzf_smallvec_t(T, N).
+ * @return TRUE if inline, FALSE if spilled to the heap.
+ */
+DZF_PUBLIC
+#define dzf_smallvec_is_inline(self) \
+    ( \
+      __die(self), \
+      ((void *)(self)->data == (void *)(self)->inline_data) \
+    )
+
+#endif /* DZF_SMALLVEC_H */
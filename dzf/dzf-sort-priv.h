@@ -0,0 +1,265 @@
+/* dzf-sort-priv.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef DZF_SORT_PRIV_H
+#define DZF_SORT_PRIV_H
+
+#if !defined(DZF_SORT_USE_AS_PRIVATE)
+#   error "Only <dzf/dzf-sort.h> can be included directly!"
+#endif
+
+#define DZF_VEC_USE_AS_PRIVATE
+#include "dzf-vector-priv.h"
+#undef  DZF_VEC_USE_AS_PRIVATE
+
+#define DZF_SORT_INSERTION_MAX 16  /* runs sorted by insertion sort */
+
+
+/* -- Private APIs -- */
+/* depth of quicksort before falling back to heapsort, 2 * log2(n) */
+DZF_PRIVATE
+static inline size_t
+__dzf_sort_depth_limit(size_t n)
+{
+    size_t depth = 0;
+
+    while (n > 1) {
+        n >>= 1;
+        depth++;
+    }
+    return depth * 2;
+}
+
+#define __dzf_sort_swap(T, x, y) \
+    do { \
+        T __tmp = (x); \
+        (x) = (y); \
+        (y) = __tmp; \
+    } while (0)
+
+/*
+ * Define the sorts of 'T' ordered by 'less', called on two values of T
+ * and inlined into every comparison.
+ */
+#define __DZF_SORT_DEFINE(name, T, less) \
+DZF_PRIVATE \
+static inline void \
+__dzf_sort_##name##_insertion(T *a, size_t lo, size_t hi) \
+{ \
+    size_t i, j; \
+    T v; \
+ \
+    for (i = lo + 1; i < hi; i++) { \
+        v = a[i]; \
+        for (j = i; j > lo && less(v, a[j - 1]); j--) \
+            a[j] = a[j - 1]; \
+        a[j] = v; \
+    } \
+} \
+ \
+DZF_PRIVATE \
+static inline void \
+__dzf_sort_##name##_sift_down(T *a, size_t root, size_t n) \
+{ \
+    T v = a[root]; \
+    size_t child; \
+ \
+    while ((child = 2 * root + 1) < n) { \
+        if (child + 1 < n && less(a[child], a[child + 1])) \
+            child++; \
+        if (!less(v, a[child])) \
+            break; \
+        a[root] = a[child]; \
+        root = child; \
+    } \
+    a[root] = v; \
+} \
+ \
+DZF_PRIVATE \
+static inline void \
+__dzf_sort_##name##_heapsort(T *a, size_t n) \
+{ \
+    size_t i; \
+ \
+    for (i = n / 2; i-- > 0; ) \
+        __dzf_sort_##name##_sift_down(a, i, n); \
+    for (i = n; i-- > 1; ) { \
+        __dzf_sort_swap(T, a[0], a[i]); \
+        __dzf_sort_##name##_sift_down(a, 0, i); \
+    } \
+} \
+ \
+/* quicksort the larger side in place, recurse into the smaller one */ \
+DZF_PRIVATE \
+static inline void \
+__dzf_sort_##name##_intro(T *a, size_t n, size_t depth) \
+{ \
+    size_t i, j, mid; \
+    T pivot; \
+ \
+    while (n > DZF_SORT_INSERTION_MAX) { \
+        if (depth-- == 0) { \
+            __dzf_sort_##name##_heapsort(a, n); \
+            return; \
+        } \
+ \
+        /* median of three, that also stops both scans below */ \
+        mid = n / 2; \
+        if (less(a[mid], a[0])) \
+            __dzf_sort_swap(T, a[mid], a[0]); \
+        if (less(a[n - 1], a[mid])) { \
+            __dzf_sort_swap(T, a[n - 1], a[mid]); \
+            if (less(a[mid], a[0])) \
+                __dzf_sort_swap(T, a[mid], a[0]); \
+        } \
+        pivot = a[mid]; \
+ \
+        /* Hoare partition, [0, j] and (j, n) */ \
+        for (i = 0, j = n - 1; ; i++, j--) { \
+            while (less(a[i], pivot)) \
+                i++; \
+            while (less(pivot, a[j])) \
+                j--; \
+            if (i >= j) \
+                break; \
+            __dzf_sort_swap(T, a[i], a[j]); \
+        } \
+ \
+        if (j + 1 < n - j - 1) { \
+            __dzf_sort_##name##_intro(a, j + 1, depth); \
+            a += j + 1; \
+            n -= j + 1; \
+        } else { \
+            __dzf_sort_##name##_intro(a + j + 1, n - j - 1, depth); \
+            n = j + 1; \
+        } \
+    } \
+    __dzf_sort_##name##_insertion(a, 0, n); \
+} \
+ \
+/* merge sorted [lo, mid) and [mid, hi) of 'src' into 'dst', left first */ \
+DZF_PRIVATE \
+static inline void \
+__dzf_sort_##name##_merge(const T *src, T *dst, \
+                          size_t lo, size_t mid, size_t hi) \
+{ \
+    size_t i = lo, j = mid, k = lo; \
+ \
+    while (i < mid && j < hi) \
+        dst[k++] = less(src[j], src[i]) ? src[j++] : src[i++]; \
+    while (i < mid) \
+        dst[k++] = src[i++]; \
+    while (j < hi) \
+        dst[k++] = src[j++]; \
+} \
+ \
+DZF_PRIVATE \
+static inline void \
+__dzf_sort_##name##_stable(void *self, T *a, size_t n) \
+{ \
+    T *buf, *src, *dst, *tmp; \
+    size_t lo, width; \
+ \
+    for (lo = 0; lo < n; lo += DZF_SORT_INSERTION_MAX) \
+        __dzf_sort_##name##_insertion(a, lo, \
+            (n - lo > DZF_SORT_INSERTION_MAX) ? lo + DZF_SORT_INSERTION_MAX : n); \
+    if (n <= DZF_SORT_INSERTION_MAX) \
+        return; \
+ \
+    /* merge runs bottom-up, back and forth between 'a' and 'buf' */ \
+    buf = __dzf_base_alloc_array(self, n, sizeof(T)); \
+    src = a; \
+    dst = buf; \
+    for (width = DZF_SORT_INSERTION_MAX; width < n; width *= 2) { \
+        for (lo = 0; lo < n; lo += 2 * width) \
+            __dzf_sort_##name##_merge(src, dst, lo, \
+                (n - lo > width) ? lo + width : n, \
+                (n - lo > 2 * width) ? lo + 2 * width : n); \
+        tmp = src; \
+        src = dst; \
+        dst = tmp; \
+    } \
+    if (src != a) \
+        memcpy(a, src, n * sizeof(T)); \
+    __dzf_base_free_array(self, buf, n, sizeof(T)); \
+}
+
+
+/*
+ * LSD radix sort of 'n' keys of unsigned 'UT' by bytes, 'flip' is
+ * xor-ed in to order signed keys. A byte all keys share skips its pass.
+ */
+#define __dzf_sort_radix_as(UT, data, scratch, n, flip) \
+    do { \
+        size_t counts[sizeof(UT)][256]; \
+        UT *src = (UT *)(data), *dst = (UT *)(scratch), *tmp; \
+        size_t b, d, i, sum; \
+ \
+        memset(counts, 0, sizeof(counts)); \
+        for (i = 0; i < (n); i++) \
+            for (b = 0; b < sizeof(UT); b++) \
+                counts[b][((src[i] ^ (flip)) >> (b * 8)) & 0xff]++; \
+ \
+        for (b = 0; b < sizeof(UT); b++) { \
+            if (counts[b][((src[0] ^ (flip)) >> (b * 8)) & 0xff] == (n)) \
+                continue; \
+            for (d = 0, sum = 0; d < 256; d++) { \
+                size_t c = counts[b][d]; \
+                counts[b][d] = sum; \
+                sum += c; \
+            } \
+            for (i = 0; i < (n); i++) \
+                dst[counts[b][((src[i] ^ (flip)) >> (b * 8)) & 0xff]++] = src[i]; \
+            tmp = src; \
+            src = dst; \
+            dst = tmp; \
+        } \
+        if (src != (UT *)(data)) \
+            memcpy((data), src, (n) * sizeof(UT)); \
+    } while (0)
+
+DZF_PRIVATE
+static inline void
+__dzf_sort_radix(void *self,
+                 Bool is_signed)
+{
+    __dzf_vec_priv_void_t *vec = self;
+    size_t elem_size = __dzf_vec_get_elem_size(vec);
+    size_t n = __dzf_vec_get_length(vec);
+    void *scratch;
+
+    if (n < 2)
+        return;
+
+    scratch = __dzf_base_alloc_array(vec, n, elem_size);
+    if (elem_size == 4)
+        __dzf_sort_radix_as(uint32_t, vec->data, scratch, n,
+                            is_signed ? (uint32_t)1 << 31 : 0);
+    else
+        __dzf_sort_radix_as(uint64_t, vec->data, scratch, n,
+                            is_signed ? (uint64_t)1 << 63 : 0);
+    __dzf_base_free_array(vec, scratch, n, elem_size);
+}
+
+#endif /* DZF_SORT_PRIV_H */
@@ -0,0 +1,137 @@
+/* dzf-sort.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! @file dzf-sort.h
+ *
+ * @brief Sorts of dzf_vec_t(T).
+ *
+ * 'DZF_SORT_DEFINE' defines the sorts of a T, with the comparison inlined
+ * instead of called through a pointer like qsort(3),
+ * - 'dzf_sort_NAME', introsort. Quicksort falls back to heapsort on a bad
+ *   pivot streak, so it is O(n log n) at worst, and is not stable.
+ * - 'dzf_stable_sort_NAME', bottom-up merge sort. It is stable and takes
+ *   buckets of as many elems as the vector from its allocator.
+ *
+ * 'dzf_radix_sort' and 'dzf_radix_sort_signed' sort integers of 4 or 8
+ * bytes in a few linear passes, taking buckets like the stable one.
+ *
+ * \b Examples
+ * @code{.c}
+ *   #define by_key(a, b) ((a).key < (b).key)
+ *
+ *   DZF_SORT_DEFINE(int, int, DZF_SORT_LESS)
+ *   DZF_SORT_DEFINE(item, struct item, by_key)
+ *
+ *   dzf_sort_int(&int_vec);
+ *   dzf_stable_sort_item(&item_vec);
+ *   dzf_radix_sort_signed(&int_vec);
+ * @endcode
+ */
+
+#ifndef DZF_SORT_H
+#define DZF_SORT_H
+
+#define DZF_SORT_USE_AS_PRIVATE
+#include "dzf-sort-priv.h"
+
+
+/*!
+ * Order values in ascending, for 'DZF_SORT_DEFINE'.
+ */
+DZF_PUBLIC
+#define DZF_SORT_LESS(a, b) ((a) < (b))
+
+/*!
+ * Define 'dzf_sort_NAME' and 'dzf_stable_sort_NAME' of dzf_vec_t(T),
+ * at file scope.
+ *
+ * Both take a vector instance of dzf_vec_t(T) and return none.
+ *
+ * @param name: suffix of the sort functions.
+ * @param T: type of elems.
+ * @param less: a function or macro of two values of T, true if the first
+ *              goes before the second.
+ */
+DZF_PUBLIC
+#define DZF_SORT_DEFINE(name, T, less) \
+__DZF_SORT_DEFINE(name, T, less) \
+ \
+DZF_PUBLIC \
+static inline void \
+dzf_sort_##name(void *self) \
+{ \
+    size_t n; \
+ \
+    __die(self); \
+    __die(__dzf_vec_get_elem_size(self) == sizeof(T)); \
+ \
+    n = __dzf_vec_get_length(self); \
+    __dzf_sort_##name##_intro((T *)(void *)DZF_VEC_VOID(self)->data, \
+                              n, __dzf_sort_depth_limit(n)); \
+} \
+ \
+DZF_PUBLIC \
+static inline void \
+dzf_stable_sort_##name(void *self) \
+{ \
+    __die(self); \
+    __die(__dzf_vec_get_elem_size(self) == sizeof(T)); \
+ \
+    __dzf_sort_##name##_stable(self, (T *)(void *)DZF_VEC_VOID(self)->data, \
+                               __dzf_vec_get_length(self)); \
+}
+
+/*!
+ * Sort unsigned integers of 4 or 8 bytes in dzf_vec_t(T) in ascending.
+ *
+ * @param self: a vector instance of dzf_vec_t(T).
+ */
+DZF_PUBLIC
+static inline void
+dzf_radix_sort(void *self)
+{
+    __die(self);
+    __die(__dzf_vec_get_elem_size(self) == 4 ||
+          __dzf_vec_get_elem_size(self) == 8);
+
+    __dzf_sort_radix(self, FALSE);
+}
+
+/*!
+ * Sort signed integers of 4 or 8 bytes in dzf_vec_t(T) in ascending.
+ *
+ * @param self: a vector instance of dzf_vec_t(T).
+ */
+DZF_PUBLIC
+static inline void
+dzf_radix_sort_signed(void *self)
+{
+    __die(self);
+    __die(__dzf_vec_get_elem_size(self) == 4 ||
+          __dzf_vec_get_elem_size(self) == 8);
+
+    __dzf_sort_radix(self, TRUE);
+}
+
+#endif /* DZF_SORT_H */
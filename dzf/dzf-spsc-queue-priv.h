@@ -0,0 +1,272 @@
+/* dzf-spsc-queue-priv.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef DZF_SPSC_QUEUE_PRIV_H
+#define DZF_SPSC_QUEUE_PRIV_H
+
+#if !defined (DZF_SPSC_QUEUE_USE_AS_PRIVATE)
+#   error "Only <dzf/dzf-spsc-queue.h> can be included directly!"
+#endif
+
+#include <stdatomic.h>
+
+#include "dzf-util.h"
+
+#define DZF_BASE_USE_AS_PRIVATE
+#include "dzf-base.h"
+#undef  DZF_BASE_USE_AS_PRIVATE
+
+/* -- Type Definition -- */
+/*!
+ * @def dzf_spsc_queue_t(T)
+ * @brief Single-producer/single-consumer queue type
+ *
+ * @param T: type that represents an elem of 'data' array.
+ *
+ * The consumer owns 'head' and the producer owns 'tail', each one on its
+ * own cache line next to a cached copy of the other side's index and the
+ * bucket reserved by the on-going operation.
+ *
+ * \b Examples
+ * @code{.c}
+ *   typedef dzf_spsc_queue_t(long) spsc_long_t;
+ *   typedef dzf_spsc_queue_t(struct job *) spsc_job_t;
+ * @endcode
+ */
+#define dzf_spsc_queue_t(T) \
+    struct { \
+        __dzf_base_t _unused1; \
+        T *data; \
+        _Alignas(DZF_CACHELINE_SIZE) atomic_size_t head; \
+        size_t tail_cache; \
+        size_t head_slot; \
+        _Alignas(DZF_CACHELINE_SIZE) atomic_size_t tail; \
+        size_t head_cache; \
+        size_t tail_slot; \
+    }
+
+typedef dzf_spsc_queue_t(void*)     __dzf_spsc_queue_priv_void_t;
+#define DZF_SPSC_QUEUE_VOID(self)   ((__dzf_spsc_queue_priv_void_t*)self)
+
+#define DZF_SPSC_QUEUE_ALLOC_SIZE 1024 /* default capacity, must be a power of two */
+
+
+/* -- Private APIs -- */
+DZF_PRIVATE
+static inline size_t
+__dzf_spsc_queue_capacity(void *self)
+{
+    return __dzf_base_get_capacity(self);
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_spsc_queue_elem_size(void *self)
+{
+    return __dzf_base_get_elem_size(self);
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_spsc_queue_mask(void *self)
+{
+    /* capacity is always a power of two */
+    return __dzf_spsc_queue_capacity(self) - 1;
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_spsc_queue_size(void *self)
+{
+    __dzf_spsc_queue_priv_void_t *q = self;
+    size_t head, tail;
+
+    /*
+     * a snapshot, it may be stale as soon as it returns. 'head' goes
+     * first, it never passes a 'tail' loaded after it.
+     */
+    head = atomic_load_explicit(&q->head, memory_order_acquire);
+    tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+
+    return tail - head;
+}
+
+
+/* producer side, reserves 'tail_slot' to write unless full */
+DZF_PRIVATE
+static inline Bool
+__dzf_spsc_queue_reserve_tail(void *self)
+{
+    __dzf_spsc_queue_priv_void_t *q = self;
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+
+    if (tail - q->head_cache == __dzf_spsc_queue_capacity(q)) {
+        /* looks full, refresh the cached head of the consumer */
+        q->head_cache = atomic_load_explicit(&q->head, memory_order_acquire);
+        if (tail - q->head_cache == __dzf_spsc_queue_capacity(q))
+            return FALSE;
+    }
+    q->tail_slot = tail & __dzf_spsc_queue_mask(q);
+
+    return TRUE;
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_spsc_queue_tail_slot(void *self)
+{
+    __dzf_spsc_queue_priv_void_t *q = self;
+
+    return q->tail_slot;
+}
+
+
+/* producer side, publishes 'tail_slot' once written */
+DZF_PRIVATE
+static inline Bool
+__dzf_spsc_queue_commit_tail(void *self)
+{
+    __dzf_spsc_queue_priv_void_t *q = self;
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+
+    return TRUE;
+}
+
+
+/* consumer side, reserves 'head_slot' to read unless empty */
+DZF_PRIVATE
+static inline Bool
+__dzf_spsc_queue_reserve_head(void *self)
+{
+    __dzf_spsc_queue_priv_void_t *q = self;
+    size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+
+    if (head == q->tail_cache) {
+        /* looks empty, refresh the cached tail of the producer */
+        q->tail_cache = atomic_load_explicit(&q->tail, memory_order_acquire);
+        if (head == q->tail_cache)
+            return FALSE;
+    }
+    q->head_slot = head & __dzf_spsc_queue_mask(q);
+
+    return TRUE;
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_spsc_queue_head_slot(void *self)
+{
+    __dzf_spsc_queue_priv_void_t *q = self;
+
+    return q->head_slot;
+}
+
+
+/* consumer side, hands 'head_slot' back once read */
+DZF_PRIVATE
+static inline Bool
+__dzf_spsc_queue_commit_head(void *self)
+{
+    __dzf_spsc_queue_priv_void_t *q = self;
+    size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+
+    return TRUE;
+}
+
+
+DZF_PRIVATE
+#define __dzf_spsc_queue_push_tail(self, value) \
+    ( \
+      !__dzf_spsc_queue_reserve_tail(self) ? FALSE : \
+      ( \
+        (self)->data[__dzf_spsc_queue_tail_slot(self)] = (value), \
+        __dzf_spsc_queue_commit_tail(self) \
+      ) \
+    )
+
+
+DZF_PRIVATE
+#define __dzf_spsc_queue_pop_head(self, out) \
+    ( \
+      !__dzf_spsc_queue_reserve_head(self) ? FALSE : \
+      ( \
+        *(out) = (self)->data[__dzf_spsc_queue_head_slot(self)], \
+        __dzf_spsc_queue_commit_head(self) \
+      ) \
+    )
+
+
+DZF_PRIVATE
+static inline int
+__dzf_spsc_queue_init(void *self,
+                      size_t elem_size, size_t capacity)
+{
+    __dzf_spsc_queue_priv_void_t *q = self;
+
+    if (capacity <= DZF_SPSC_QUEUE_ALLOC_SIZE)
+        capacity = DZF_SPSC_QUEUE_ALLOC_SIZE;
+    capacity = dzf_next_pow2(capacity);
+
+    __dzf_base_init(q, 0, capacity, elem_size);
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    q->head_cache = 0;
+    q->tail_cache = 0;
+    q->head_slot = 0;
+    q->tail_slot = 0;
+    q->data = (void **)__dzf_base_alloc_array(q, capacity, elem_size);
+
+    return 0;
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_spsc_queue_data_free(void *self)
+{
+    __dzf_spsc_queue_priv_void_t *q = self;
+
+    if (q->data != NULL) {
+        __dzf_base_free_array(q, q->data,
+                              __dzf_spsc_queue_capacity(q),
+                              __dzf_spsc_queue_elem_size(q));
+        q->data = NULL;
+    }
+    __dzf_base_init(q, 0, 0, 0);
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    q->head_cache = 0;
+    q->tail_cache = 0;
+}
+
+#endif /* DZF_SPSC_QUEUE_PRIV_H */
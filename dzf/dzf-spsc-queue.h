@@ -0,0 +1,216 @@
+/* dzf-spsc-queue.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! @file dzf-spsc-queue.h
+ *
+ * @brief Single-Producer/Single-Consumer Queue Type Structure.
+ *
+ * dzf_spsc_queue_t(T) is a bounded circular queue, like dzf_queue_t(T),
+ * that hands elements from exactly one producer thread over to exactly
+ * one consumer thread without any lock. Default capacity is '1024' unless
+ * clarify the size via initializer, and it is always rounded up to a
+ * power of two.
+ *
+ * Both sides are wait-free, they never block and fail instead on full or
+ * empty. The head and tail indices are C11 atomics published with
+ * acquire/release ordering, hence it requires a C11 compiler.
+ *
+ * Note that neither of initializers nor 'data_free' is thread-safe.
+ */
+
+#ifndef DZF_SPSC_QUEUE_H
+#define DZF_SPSC_QUEUE_H
+
+#define DZF_SPSC_QUEUE_USE_AS_PRIVATE
+#include "dzf-spsc-queue-priv.h"
+
+
+/*!
+ * Initialize a dzf_spsc_queue_t(T) instance.
+ *
+ * @param self: an instance of dzf_spsc_queue_t(T).
+ * @param elem_size: each element size in byte unit.
+ * @param capacity: number of elements in the queue.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_spsc_queue_init(void *self,
+                    size_t elem_size, size_t capacity)
+{
+    __die(self);
+
+    return __dzf_spsc_queue_init(self, elem_size, capacity);
+}
+
+/*!
+ * Initialize a dzf_spsc_queue_t(T) instance with capacity '1024'.
+ *
+ * @param self: an instance of dzf_spsc_queue_t(T).
+ * @param elem_size: each element size in byte unit.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_spsc_queue_new(void *self,
+                   size_t elem_size)
+{
+    __die(self);
+
+    return __dzf_spsc_queue_init(self, elem_size, DZF_SPSC_QUEUE_ALLOC_SIZE);
+}
+
+/*!
+ * Free the data of dzf_spsc_queue_t(T).
+ * Note that it doesn't free queue itself if from aligned_alloc.
+ *
+ * @param self: an instance of dzf_spsc_queue_t(T).
+ * @return none
+ */
+DZF_PUBLIC
+static inline void
+dzf_spsc_queue_data_free(void *self)
+{
+    __die(self);
+
+    __dzf_spsc_queue_data_free(self);
+}
+
+/*!
+ * Free the data and dzf_spsc_queue_t(T) itself.
+ * Note that the instance must be alloc'ed by
+ * 'aligned_alloc(DZF_CACHELINE_SIZE, ...)', malloc is not enough for
+ * its cache-line aligned members.
+ *
+ * @param self: an instance of dzf_spsc_queue_t(T).
+ * @return none
+ */
+DZF_PUBLIC
+static inline void
+dzf_spsc_queue_free(void *self)
+{
+    __die(self);
+
+    __dzf_spsc_queue_data_free(self);
+    free(self);
+}
+
+/*!
+ * Get the size of each element of dzf_spsc_queue_t(T).
+ *
+ * @param self: an instance of dzf_spsc_queue_t(T).
+ * @return the size of each element.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_spsc_queue_elem_size(void *self)
+{
+    __die(self);
+
+    return __dzf_spsc_queue_elem_size(self);
+}
+
+/*!
+ * Get the capacity of dzf_spsc_queue_t(T).
+ *
+ * @param self: an instance of dzf_spsc_queue_t(T).
+ * @return the capacity.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_spsc_queue_capacity(void *self)
+{
+    __die(self);
+
+    return __dzf_spsc_queue_capacity(self);
+}
+
+/*!
+ * Get the number of elements in dzf_spsc_queue_t(T).
+ *
+ * Note that it is a snapshot while the other side is running.
+ *
+ * @param self: an instance of dzf_spsc_queue_t(T).
+ * @return the number of elements.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_spsc_queue_size(void *self)
+{
+    __die(self);
+
+    return __dzf_spsc_queue_size(self);
+}
+
+/*!
+ * Is dzf_spsc_queue_t(T) empty?
+ *
+ * Note that it is a snapshot while the other side is running.
+ *
+ * @param self: an instance of dzf_spsc_queue_t(T).
+ * @return TRUE if empty, otherwise FALSE.
+ */
+DZF_PUBLIC
+static inline Bool
+dzf_spsc_queue_is_empty(void *self)
+{
+    __die(self);
+
+    return (__dzf_spsc_queue_size(self) == 0) ? TRUE : FALSE;
+}
+
+/*!
+ * Try to enqueue a new value to the tail of dzf_spsc_queue_t(T).
+ *
+ * Must be called from the producer thread only.
+ *
+ * @param self: an instance of dzf_spsc_queue_t(T).
+ * @param value: a new value.
+ * @return TRUE on success, FALSE if full.
+ */
+DZF_PUBLIC
+#define dzf_spsc_queue_try_enq(self, value) \
+    ( \
+      __die(self), \
+      __dzf_spsc_queue_push_tail(self, value) \
+    )
+
+/*!
+ * Try to dequeue a value from the head of dzf_spsc_queue_t(T).
+ *
+ * Must be called from the consumer thread only.
+ *
+ * @param self: an instance of dzf_spsc_queue_t(T).
+ * @param out: a pointer to T that receives the value.
+ * @return TRUE on success, FALSE if empty.
+ */
+DZF_PUBLIC
+#define dzf_spsc_queue_try_deq(self, out) \
+    ( \
+      __die(self), \
+      __die(out), \
+      __dzf_spsc_queue_pop_head(self, out) \
+    )
+
+#endif /* DZF_SPSC_QUEUE_H */
@@ -95,27 +95,46 @@ __dzf_stack_elem_size(void *self)
 
 
 DZF_PRIVATE
-static inline int
-__dzf_stack_set_top(void *self,
-                    int new_top)
+static inline size_t
+__dzf_stack_set_size(void *self,
+                     size_t new_size)
 {
-    return __dzf_base_set_length(self, new_top);
+    return __dzf_base_set_length(self, new_size);
 }
 
 
 DZF_PRIVATE
-static inline int
-__dzf_stack_top(void *self)
+static inline size_t
+__dzf_stack_size(void *self)
 {
     return __dzf_base_get_length(self);
 }
 
 
+/* index of the top elem, -1 if empty */
 DZF_PRIVATE
-static inline int
-__dzf_stack_size(void *self)
+static inline ptrdiff_t
+__dzf_stack_top(void *self)
+{
+    return (ptrdiff_t)__dzf_stack_size(self) - 1;
+}
+
+
+/* returns the bucket for a new top */
+DZF_PRIVATE
+static inline size_t
+__dzf_stack_inc_top(void *self)
+{
+    return DZF_GET_BASE(self)->length++;
+}
+
+
+/* returns the bucket of the old top */
+DZF_PRIVATE
+static inline size_t
+__dzf_stack_dec_top(void *self)
 {
-    return __dzf_stack_top(self) + 1;
+    return --DZF_GET_BASE(self)->length;
 }
 
 
@@ -123,7 +142,7 @@ DZF_PRIVATE
 static inline Bool
 __dzf_stack_is_empty(void *self)
 {
-    return (__dzf_stack_top(self) == -1 ? TRUE : FALSE);
+    return (__dzf_stack_size(self) == 0 ? TRUE : FALSE);
 }
 
 
@@ -131,21 +150,32 @@ DZF_PRIVATE
 static inline Bool
 __dzf_stack_is_full(void *self)
 {
-    if (__dzf_stack_size(self) == 0)
-        return FALSE;
     /* assume always 'alloc_size >= stack_size' */
-    return (__dzf_stack_alloc_size(self) - __dzf_stack_size(self)
-            ? FALSE : TRUE);
+    return (__dzf_stack_alloc_size(self) == __dzf_stack_size(self)
+            ? TRUE : FALSE);
 }
 
 
 DZF_PRIVATE
 static inline int
 __dzf_stack_init(void *self,
-                 size_t elem_size, size_t capacity)
+                 size_t elem_size, size_t capacity,
+                 const dzf_allocator_t *allocator)
+{
+    __dzf_vec_init(self, elem_size, capacity /* as alloc size */, allocator);
+    __dzf_stack_set_size(self, 0);
+
+    return 0;
+}
+
+
+DZF_PRIVATE
+static inline int
+__dzf_stack_init_with_buffer(void *self,
+                             size_t elem_size, void *buf, size_t capacity)
 {
-    __dzf_vec_init(self, elem_size, capacity /* as alloc size */);
-    __dzf_stack_set_top(self, -1);
+    __dzf_vec_init_with_buffer(self, elem_size, buf, capacity);
+    __dzf_stack_set_size(self, 0);
 
     return 0;
 }
@@ -160,7 +190,7 @@ __dzf_stack_data_free(void *self)
 
 
 DZF_PRIVATE
-static inline int
+static inline size_t
 __dzf_stack_try_growing(void *self)
 {
     /*
@@ -172,6 +202,7 @@ __dzf_stack_try_growing(void *self)
 #if defined(DZF_STACK_STATIC_SIZE)
     /* abort at runtime if try growing */
     __die(FALSE);
+    return 0;
 #else
     return __dzf_vec_try_growing(self);
 #endif
@@ -182,8 +213,7 @@ DZF_PRIVATE
 #define __dzf_stack_push(self, val) \
     ( \
       __dzf_stack_is_full(self) ? __dzf_stack_try_growing(self) : 0, \
-      __dzf_stack_set_top(self, __dzf_stack_size(self)), \
-      (self)->data[__dzf_stack_top(self)] = val, \
+      (self)->data[__dzf_stack_inc_top(self)] = val, \
       (void)0 /* represents success */ \
     )
 
@@ -191,7 +221,7 @@ DZF_PRIVATE
 DZF_PRIVATE
 #define __dzf_stack_pop(self) \
     ( \
-      (self)->data[DZF_GET_BASE(self)->length--] \
+      (self)->data[__dzf_stack_dec_top(self)] \
     )
 
 
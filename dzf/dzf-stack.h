@@ -62,7 +62,50 @@ dzf_stack_init(void *self,
 {
     __die(self);
 
-    return __dzf_stack_init(self, elem_size, capacity);
+    return __dzf_stack_init(self, elem_size, capacity, NULL);
+}
+
+/*!
+ * Initialize a dzf_stack_t(T) instance whose buckets come from the allocator.
+ *
+ * @param self: a stack instance of dzf_stack_t(T).
+ * @param elem_size: each element size in byte unit.
+ * @param capacity: number of elements in the stack.
+ * @param allocator: an allocator that outlives the stack, NULL for default.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_stack_init_with_allocator(void *self,
+                              size_t elem_size, size_t capacity,
+                              const dzf_allocator_t *allocator)
+{
+    __die(self);
+
+    return __dzf_stack_init(self, elem_size, capacity, allocator);
+}
+
+/*!
+ * Initialize a dzf_stack_t(T) instance on caller-provided buckets.
+ *
+ * Nothing is allocated and 'buf' is never freed. Once the stack
+ * outgrows 'buf', its elems are copied out to the heap, unless
+ * 'DZF_STACK_STATIC_SIZE' is defined.
+ *
+ * @param self: a stack instance of dzf_stack_t(T).
+ * @param elem_size: each element size in byte unit.
+ * @param buf: buckets that outlive the stack, at least 'capacity' elems.
+ * @param capacity: number of elements 'buf' can hold.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_stack_init_with_buffer(void *self,
+                           size_t elem_size, void *buf, size_t capacity)
+{
+    __die(self);
+
+    return __dzf_stack_init_with_buffer(self, elem_size, buf, capacity);
 }
 
 /*!
@@ -79,7 +122,7 @@ dzf_stack_new(void *self,
 {
     __die(self);
 
-    return __dzf_stack_init(self, elem_size, DZF_STACK_ALLOC_SIZE);
+    return __dzf_stack_init(self, elem_size, DZF_STACK_ALLOC_SIZE, NULL);
 }
 
 /*!
@@ -112,7 +155,6 @@ dzf_stack_free(void *self)
     __die(self);
 
     __dzf_vec_data_free(self);
-    __dzf_stack_set_top(self, -1);
     free(self);
 }
 
@@ -123,7 +165,7 @@ dzf_stack_free(void *self)
  * @return the size of current used buckets.
  */
 DZF_PUBLIC
-static inline int
+static inline size_t
 dzf_stack_size(void *self)
 {
     __die(self);
@@ -251,7 +293,7 @@ DZF_PUBLIC
 
 DZF_PUBLIC
 #define dzf_stack_foreach(self, _fptr, ...) \
-    for ( int i = 0; \
+    for ( size_t i = 0; \
           i < __dzf_stack_size(self); \
           (_fptr)(&((self)->data[i]), __VA_ARGS__), ++i )
         
@@ -26,11 +26,15 @@
 #define DZF_UTIL_H
 
 #include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
 #include <assert.h>
 
+#define DZF_CACHELINE_SIZE 64 /* in byte unit */
+
 #define Bool     int
 #define TRUE     1
 #define FALSE    0
@@ -73,10 +77,73 @@ dzf_malloc(size_t size)
   return dzf_realloc(NULL, size);
 }
 
+/* 'nmemb * size', exit if it overflows like dzf_realloc */
+static inline size_t
+dzf_mul_size(size_t nmemb, size_t size)
+{
+  if (size && nmemb > SIZE_MAX / size)
+      exit(-1);
+
+  return nmemb * size;
+}
+
+static inline void *
+dzf_realloc_array(void *oldptr, size_t nmemb, size_t size)
+{
+  return dzf_realloc(oldptr, dzf_mul_size(nmemb, size));
+}
+
+static inline void *
+dzf_malloc_array(size_t nmemb, size_t size)
+{
+  return dzf_realloc_array(NULL, nmemb, size);
+}
+
+/* round up to the next power of two, 'n' itself if it is */
+static inline size_t
+dzf_next_pow2(size_t n)
+{
+  size_t p = 1;
+
+  if (n > (SIZE_MAX >> 1) + 1)
+      exit(-1);
+
+  while (p < n)
+    p <<= 1;
+
+  return p;
+}
+
 #define dzf_cmp(x, y) __dzf_cmp(x, y)
 #define __dzf_cmp(_x, _y) \
     ( ((_x) == (_y)) ? TRUE : FALSE )
 
+/* hash and equality callbacks of hashed containers, on raw key bytes */
+typedef size_t (*dzf_hash_fn)(const void *key, size_t key_size);
+typedef Bool   (*dzf_eq_fn)(const void *a, const void *b, size_t key_size);
+
+/*
+ * A wrapper of 'T' that owns whole cache lines, so neighbours in an array
+ * of per-thread containers don't false-share their headers.
+ *
+ *   dzf_cacheline_padded(vec_int_t) per_thread[NR_THREADS];
+ *   dzf_vec_new(&per_thread[i].value, sizeof(int));
+ */
+#define dzf_cacheline_padded(T) \
+    struct { \
+        _Alignas(DZF_CACHELINE_SIZE) T value; \
+    }
+
+/* alignment of the type of 'expr', or else a multiple of it */
+#if defined(__GNUC__) || defined(__clang__)
+#   define dzf_alignof(expr) __alignof__(expr)
+#else
+#   define dzf_alignof(expr) (sizeof(expr) & (~sizeof(expr) + 1))
+#endif
+
+#define dzf_array_size(arr) \
+    (sizeof(arr) / sizeof((arr)[0]))
+
 #define dzf_sizeof(ptr) __dzf_sizeof(ptr)
 #define __dzf_sizeof(_ptr) \
     sizeof((_ptr)->data[0])
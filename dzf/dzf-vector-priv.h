@@ -33,6 +33,20 @@
 #include "dzf-base.h"
 #undef  DZF_BASE_USE_AS_PRIVATE
 
+/*
+ * scan for values with SSE2 unless told not to, and with AVX2 as well
+ * on CPUs that have it, picked at runtime
+ */
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__)) \
+    && !defined(DZF_VEC_NO_SIMD)
+#   define DZF_VEC_SSE2
+#   include <emmintrin.h>
+#   if defined(__x86_64__) || defined(__i386__)
+#       define DZF_VEC_AVX2
+#       include <immintrin.h>
+#   endif
+#endif
+
 /* -- Type Definition -- */
 /*!
  * @def dzf_vec_t(T)
@@ -58,19 +72,36 @@ typedef dzf_vec_t(char) __dzf_vec_priv_void_t;
 
 #define DZF_VEC_ALLOC_SIZE 8 /* default capacity */
 
+#define DZF_VEC_NPOS ((size_t)-1) /* index of no elem */
+
+/* -- Growth Policies -- */
+#define DZF_VEC_GROW_DEFAULT  0 /* follow DZF_VEC_GROW_POLICY */
+#define DZF_VEC_GROW_DOUBLE   1 /* alloc_size * 2 */
+#define DZF_VEC_GROW_HALF     2 /* alloc_size * 1.5 */
+#define DZF_VEC_GROW_STEP     3 /* alloc_size + arg */
+#define DZF_VEC_GROW_CHUNK    4 /* alloc_size * 2, but by arg at most */
+
+/* compile-time default, e.g. -DDZF_VEC_GROW_POLICY=DZF_VEC_GROW_HALF */
+#if !defined(DZF_VEC_GROW_POLICY)
+#   define DZF_VEC_GROW_POLICY  DZF_VEC_GROW_DOUBLE
+#endif
+#if !defined(DZF_VEC_GROW_ARG)
+#   define DZF_VEC_GROW_ARG     0
+#endif
+
 
 /* -- Private APIs -- */
 DZF_PRIVATE
-static inline int
+static inline size_t
 __dzf_vec_set_length(void *self,
-                     int length)
+                     size_t length)
 {
     return __dzf_base_set_length(self, length);
 }
 
 
 DZF_PRIVATE
-static inline int
+static inline size_t
 __dzf_vec_get_length(void *self)
 {
     return __dzf_base_get_length(self);
@@ -114,14 +145,24 @@ __dzf_vec_get_elem_size(void *self)
 DZF_PRIVATE
 static inline Bool
 __dzf_vec_index_validator(void *self,
-                          int index)
+                          size_t index)
 {
-    return (index >= 0 && index < __dzf_vec_get_length(self));
+    return (index < __dzf_vec_get_length(self));
 }
 
 
+/* an insert may also go right after the last elem */
 DZF_PRIVATE
-static inline int
+static inline Bool
+__dzf_vec_insert_validator(void *self,
+                           size_t index)
+{
+    return (index <= __dzf_vec_get_length(self));
+}
+
+
+DZF_PRIVATE
+static inline size_t
 __dzf_vec_get_capacity(void *self)
 {
     return __dzf_vec_get_alloc_size(self) - __dzf_vec_get_length(self);
@@ -145,25 +186,170 @@ __dzf_vec_is_empty(void *self)
 
 
 DZF_PRIVATE
-static inline int
-__dzf_vec_try_growing(void *self)
+static inline Bool
+__dzf_vec_is_borrowed(void *self)
+{
+    return __dzf_base_has_flag(self, DZF_BASE_FLAG_BORROWED);
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_vec_next_alloc_size(void *self)
+{
+    size_t old_size = __dzf_vec_get_alloc_size(self);
+    unsigned int policy = __dzf_base_get_grow_policy(self);
+    size_t arg = __dzf_base_get_grow_arg(self);
+    size_t new_size;
+
+    if (policy == DZF_VEC_GROW_DEFAULT) {
+        policy = DZF_VEC_GROW_POLICY;
+        arg = DZF_VEC_GROW_ARG;
+    }
+
+    switch (policy) {
+    case DZF_VEC_GROW_HALF:
+        new_size = old_size + old_size / 2;
+        break;
+    case DZF_VEC_GROW_STEP:
+        new_size = old_size + arg;
+        break;
+    case DZF_VEC_GROW_CHUNK:
+        new_size = old_size + ((arg && old_size > arg) ? arg : old_size);
+        break;
+    case DZF_VEC_GROW_DOUBLE:
+    default:
+        new_size = old_size * 2;
+        break;
+    }
+
+    /* grow by one elem at least */
+    return (new_size > old_size) ? new_size : old_size + 1;
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_vec_grow_to(void *self,
+                  size_t new_alloc_size)
 {
     __dzf_vec_priv_void_t *vec = self;
-    size_t new_alloc_size = 0;
+    void *newm;
+
+    if (__dzf_vec_is_borrowed(vec)) {
+        /* copy out of the borrowed buckets, they are ours from now on */
+        newm = __dzf_base_alloc_array(vec, new_alloc_size,
+                                      __dzf_vec_get_elem_size(vec));
+        memcpy(newm, vec->data,
+               __dzf_vec_get_elem_size(vec) * __dzf_vec_get_length(vec));
+        vec->data = newm;
+        __dzf_vec_set_alloc_size(vec, new_alloc_size);
+        __dzf_base_toggle_flag(vec, DZF_BASE_FLAG_BORROWED, FALSE);
+
+        return new_alloc_size;
+    }
 
-    new_alloc_size = __dzf_vec_get_alloc_size(vec) * 2;
-    vec->data = dzf_realloc(vec->data,
-                            __dzf_vec_get_elem_size(vec) * new_alloc_size);
+    vec->data = __dzf_base_realloc_array(vec, vec->data,
+                                         __dzf_vec_get_alloc_size(vec),
+                                         new_alloc_size,
+                                         __dzf_vec_get_elem_size(vec));
     __dzf_vec_set_alloc_size(vec, new_alloc_size);
 
     return new_alloc_size;
 }
 
 
+DZF_PRIVATE
+static inline size_t
+__dzf_vec_try_growing(void *self)
+{
+    return __dzf_vec_grow_to(self, __dzf_vec_next_alloc_size(self));
+}
+
+
+/* grow once, following the growth policy, to hold 'length' elems */
+DZF_PRIVATE
+static inline size_t
+__dzf_vec_grow_for(void *self,
+                   size_t length)
+{
+    __dzf_base_t probe = *DZF_GET_BASE(self);
+
+    if (length <= __dzf_vec_get_alloc_size(self))
+        return __dzf_vec_get_alloc_size(self);
+
+    /* walk the policy on a copy, then realloc just once */
+    while (probe.alloc_size < length)
+        probe.alloc_size = __dzf_vec_next_alloc_size(&probe);
+
+    return __dzf_vec_grow_to(self, probe.alloc_size);
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_vec_reserve(void *self,
+                  size_t alloc_size)
+{
+    if (alloc_size <= __dzf_vec_get_alloc_size(self))
+        return __dzf_vec_get_alloc_size(self);
+
+    return __dzf_vec_grow_to(self, alloc_size);
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_vec_shrink_to(void *self,
+                    size_t new_alloc_size)
+{
+    /* never drop the buckets entirely, nor below the elems in use */
+    if (new_alloc_size < __dzf_vec_get_length(self))
+        new_alloc_size = __dzf_vec_get_length(self);
+    if (new_alloc_size < 1)
+        new_alloc_size = 1;
+
+    /* borrowed buckets are not ours to give back */
+    if (new_alloc_size >= __dzf_vec_get_alloc_size(self) ||
+        __dzf_vec_is_borrowed(self))
+        return __dzf_vec_get_alloc_size(self);
+
+    return __dzf_vec_grow_to(self, new_alloc_size);
+}
+
+
+DZF_PRIVATE
+static inline Bool
+__dzf_vec_is_auto_shrink(void *self)
+{
+    return __dzf_base_has_flag(self, DZF_BASE_FLAG_AUTO_SHRINK);
+}
+
+
+/*
+ * Halve the buckets once less than a quarter of them is in use, so that
+ * growing at full and shrinking don't bounce on the same boundary.
+ */
+DZF_PRIVATE
+static inline size_t
+__dzf_vec_try_shrinking(void *self)
+{
+    size_t alloc_size = __dzf_vec_get_alloc_size(self);
+
+    if (!__dzf_vec_is_auto_shrink(self) ||
+        alloc_size / 2 < DZF_VEC_ALLOC_SIZE ||
+        __dzf_vec_get_length(self) >= alloc_size / 4)
+        return 0;
+
+    return __dzf_vec_shrink_to(self, alloc_size / 2);
+}
+
+
 DZF_PRIVATE
 static inline int
-__dzf_vec_init(void *self,
-               size_t elem_size, size_t capacity)
+__dzf_vec_init_aligned(void *self,
+                       size_t elem_size, size_t capacity,
+                       const dzf_allocator_t *allocator, size_t align)
 {
     __dzf_vec_priv_void_t *vec = self;
 
@@ -173,7 +359,38 @@ __dzf_vec_init(void *self,
     memset(vec, 0, sizeof(*vec));
 
     __dzf_base_init(vec, 0, capacity, elem_size);
-    vec->data = dzf_malloc(elem_size * capacity);
+    if (allocator)
+        __dzf_base_set_allocator(vec, allocator);
+    __dzf_base_set_align(vec, align);
+    vec->data = __dzf_base_alloc_array(vec, capacity, elem_size);
+
+    return 0;
+}
+
+
+DZF_PRIVATE
+static inline int
+__dzf_vec_init(void *self,
+               size_t elem_size, size_t capacity,
+               const dzf_allocator_t *allocator)
+{
+    return __dzf_vec_init_aligned(self, elem_size, capacity, allocator, 0);
+}
+
+
+/* 'buf' is borrowed until the vector outgrows it */
+DZF_PRIVATE
+static inline int
+__dzf_vec_init_with_buffer(void *self,
+                           size_t elem_size, void *buf, size_t capacity)
+{
+    __dzf_vec_priv_void_t *vec = self;
+
+    memset(vec, 0, sizeof(*vec));
+
+    __dzf_base_init(vec, 0, capacity, elem_size);
+    __dzf_base_toggle_flag(vec, DZF_BASE_FLAG_BORROWED, TRUE);
+    vec->data = buf;
 
     return 0;
 }
@@ -186,7 +403,10 @@ __dzf_vec_data_free(void *self)
     __dzf_vec_priv_void_t *vec = self;
 
     if (vec->data != NULL) {
-        free(vec->data);
+        if (!__dzf_vec_is_borrowed(vec))
+            __dzf_base_free_array(vec, vec->data,
+                                  __dzf_vec_get_alloc_size(vec),
+                                  __dzf_vec_get_elem_size(vec));
         vec->data = NULL;
     }
     __dzf_base_init(vec, 0, 0, 0);
@@ -244,9 +464,9 @@ DZF_PRIVATE
 
 DZF_PRIVATE
 #define __dzf_vec_self_memmove(self, _idx, _direction) \
-   memmove(__dzf_vec_get_ptr_at(self, _idx _direction), \
-           __dzf_vec_get_ptr_at(self, _idx), \
-           __dzf_vec_get_length(self) - _idx)
+   memmove(__dzf_vec_get_ptr_at(self, (_idx) _direction), \
+           __dzf_vec_get_ptr_at(self, (_idx)), \
+           __dzf_vec_get_elem_size(self) * (__dzf_vec_get_length(self) - (_idx)))
 
 
 DZF_PRIVATE
@@ -265,7 +485,326 @@ DZF_PRIVATE
     ( \
         (_idx == __dzf_vec_get_length(self)) \
             ? NULL : __dzf_vec_self_memmove(self, _idx+1, __left_x(1)), \
-        __dzf_vec_set_length(self, __dzf_vec_get_length(self)-1) \
+        __dzf_vec_set_length(self, __dzf_vec_get_length(self)-1), \
+        __dzf_vec_try_shrinking(self) \
     )
 
+DZF_PRIVATE
+static inline void
+__dzf_vec_insert_range(void *self,
+                       size_t index, const void *src, size_t n)
+{
+    size_t length = __dzf_vec_get_length(self);
+    size_t elem_size = __dzf_vec_get_elem_size(self);
+
+    __dzf_vec_grow_for(self, length + n);
+
+    /* shift the tail once for all 'n' elems */
+    if (index < length)
+        memmove(__dzf_vec_get_ptr_at(self, index + n),
+                __dzf_vec_get_ptr_at(self, index),
+                elem_size * (length - index));
+    memcpy(__dzf_vec_get_ptr_at(self, index), src, elem_size * n);
+    __dzf_vec_set_length(self, length + n);
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_vec_erase_range(void *self,
+                      size_t index, size_t n)
+{
+    size_t length = __dzf_vec_get_length(self);
+
+    /* shift the tail once for all 'n' elems */
+    if (index + n < length)
+        memmove(__dzf_vec_get_ptr_at(self, index),
+                __dzf_vec_get_ptr_at(self, index + n),
+                __dzf_vec_get_elem_size(self) * (length - index - n));
+    __dzf_vec_set_length(self, length - n);
+    __dzf_vec_try_shrinking(self);
+}
+
+DZF_PRIVATE
+static inline void
+__dzf_vec_swap_remove_at(void *self,
+                         size_t index)
+{
+    size_t last = __dzf_vec_get_length(self) - 1;
+
+    /* fill the hole with the last elem instead of shifting the tail */
+    if (index != last)
+        memcpy(__dzf_vec_get_ptr_at(self, index),
+               __dzf_vec_get_ptr_at(self, last),
+               __dzf_vec_get_elem_size(self));
+    __dzf_vec_set_length(self, last);
+    __dzf_vec_try_shrinking(self);
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_vec_retain_if(void *self,
+                    Bool (*pred)(const void *elem, void *user_data),
+                    void *user_data)
+{
+    size_t length = __dzf_vec_get_length(self);
+    size_t elem_size = __dzf_vec_get_elem_size(self);
+    size_t r, w;
+
+    /* compact the kept elems to the front in one sweep, in order */
+    for (r = 0, w = 0; r < length; r++) {
+        if (!pred(__dzf_vec_get_ptr_at(self, r), user_data))
+            continue;
+        if (r != w)
+            memcpy(__dzf_vec_get_ptr_at(self, w),
+                   __dzf_vec_get_ptr_at(self, r), elem_size);
+        w++;
+    }
+    __dzf_vec_set_length(self, w);
+    __dzf_vec_try_shrinking(self);
+
+    return length - w;
+}
+
+
+/*
+ * Scan 'n' elems of 'elem_size' for 'value'. Returns the index of the
+ * first match, or 'n' if none, unless 'count_all' that it returns the
+ * number of matches.
+ */
+DZF_PRIVATE
+static inline size_t
+__dzf_vec_scan_bytes(const char *data, size_t n, size_t elem_size,
+                     const void *value, Bool count_all)
+{
+    size_t i, hits = 0;
+
+    for (i = 0; i < n; i++) {
+        if (memcmp(data + i * elem_size, value, elem_size) != 0)
+            continue;
+        if (!count_all)
+            return i;
+        hits++;
+    }
+
+    return count_all ? hits : n;
+}
+
+
+/*
+ * Like __dzf_vec_scan_bytes for elems of 1, 2, 4 or 8 bytes, 'needle'
+ * holds the bytes of the value.
+ */
+DZF_PRIVATE
+static inline size_t
+__dzf_vec_scan_scalar(const char *data, size_t n, size_t elem_size,
+                      const uint64_t *needle, Bool count_all)
+{
+    size_t i, hits = 0;
+
+    /* elems are read through memcpy, T may be a float or a struct */
+#define __DZF_VEC_SCAN_AS(T) \
+    do { \
+        T v, e; \
+        memcpy(&v, needle, sizeof(T)); \
+        for (i = 0; i < n; i++) { \
+            memcpy(&e, data + i * sizeof(T), sizeof(T)); \
+            if (e != v) \
+                continue; \
+            if (!count_all) \
+                return i; \
+            hits++; \
+        } \
+    } while (0)
+
+    switch (elem_size) {
+    case 1: __DZF_VEC_SCAN_AS(uint8_t);  break;
+    case 2: __DZF_VEC_SCAN_AS(uint16_t); break;
+    case 4: __DZF_VEC_SCAN_AS(uint32_t); break;
+    default: __DZF_VEC_SCAN_AS(uint64_t);
+    }
+#undef __DZF_VEC_SCAN_AS
+
+    return count_all ? hits : n;
+}
+
+
+#if defined(DZF_VEC_SSE2)
+/* the value of 1, 2, 4 or 8 bytes in 'needle' to broadcast */
+DZF_PRIVATE
+static inline uint64_t
+__dzf_vec_needle(const uint64_t *needle, size_t elem_size)
+{
+    uint8_t u8;
+    uint16_t u16;
+    uint32_t u32;
+
+    switch (elem_size) {
+    case 1:  memcpy(&u8, needle, 1);  return u8;
+    case 2:  memcpy(&u16, needle, 2); return u16;
+    case 4:  memcpy(&u32, needle, 4); return u32;
+    default: return *needle;
+    }
+}
+
+
+/* a bit per matching byte of the 16 bytes at 'p' */
+DZF_PRIVATE
+static inline unsigned int
+__dzf_vec_sse2_match(const char *p, __m128i needle, size_t elem_size)
+{
+    __m128i block = _mm_loadu_si128((const __m128i *)(const void *)p);
+    __m128i eq;
+
+    switch (elem_size) {
+    case 1: eq = _mm_cmpeq_epi8(block, needle);  break;
+    case 2: eq = _mm_cmpeq_epi16(block, needle); break;
+    case 4: eq = _mm_cmpeq_epi32(block, needle); break;
+    default:
+        /* no 64-bit compare in SSE2, both halves must match */
+        eq = _mm_cmpeq_epi32(block, needle);
+        eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+
+    return (unsigned int)_mm_movemask_epi8(eq);
+}
+
+DZF_PRIVATE
+static inline size_t
+__dzf_vec_scan_sse2(const char *data, size_t n, size_t elem_size,
+                    const uint64_t *needle, Bool count_all)
+{
+    size_t lanes = 16 / elem_size;
+    size_t i, hits = 0;
+    unsigned int bits;
+    __m128i vneedle;
+    uint64_t v = __dzf_vec_needle(needle, elem_size);
+
+    switch (elem_size) {
+    case 1: vneedle = _mm_set1_epi8((char)v);            break;
+    case 2: vneedle = _mm_set1_epi16((short)v);          break;
+    case 4: vneedle = _mm_set1_epi32((int)v);            break;
+    default: vneedle = _mm_set1_epi64x((long long)v);
+    }
+
+    for (i = 0; i + lanes <= n; i += lanes) {
+        if (!(bits = __dzf_vec_sse2_match(data + i * elem_size,
+                                          vneedle, elem_size)))
+            continue;
+        if (!count_all)
+            return i + (size_t)__builtin_ctz(bits) / elem_size;
+        hits += (size_t)__builtin_popcount(bits) / elem_size;
+    }
+
+    if (count_all)
+        return hits + __dzf_vec_scan_scalar(data + i * elem_size, n - i,
+                                            elem_size, needle, TRUE);
+    return i + __dzf_vec_scan_scalar(data + i * elem_size, n - i,
+                                     elem_size, needle, FALSE);
+}
+#endif /* DZF_VEC_SSE2 */
+
+
+#if defined(DZF_VEC_AVX2)
+/* a bit per matching byte of the 32 bytes at 'p' */
+__attribute__((target("avx2")))
+DZF_PRIVATE
+static inline unsigned int
+__dzf_vec_avx2_match(const char *p, __m256i needle, size_t elem_size)
+{
+    __m256i block = _mm256_loadu_si256((const __m256i *)(const void *)p);
+    __m256i eq;
+
+    switch (elem_size) {
+    case 1: eq = _mm256_cmpeq_epi8(block, needle);  break;
+    case 2: eq = _mm256_cmpeq_epi16(block, needle); break;
+    case 4: eq = _mm256_cmpeq_epi32(block, needle); break;
+    default: eq = _mm256_cmpeq_epi64(block, needle);
+    }
+
+    return (unsigned int)_mm256_movemask_epi8(eq);
+}
+
+__attribute__((target("avx2")))
+DZF_PRIVATE
+static inline size_t
+__dzf_vec_scan_avx2(const char *data, size_t n, size_t elem_size,
+                    const uint64_t *needle, Bool count_all)
+{
+    size_t lanes = 32 / elem_size;
+    size_t i, hits = 0;
+    unsigned int bits;
+    __m256i vneedle;
+    uint64_t v = __dzf_vec_needle(needle, elem_size);
+
+    switch (elem_size) {
+    case 1: vneedle = _mm256_set1_epi8((char)v);           break;
+    case 2: vneedle = _mm256_set1_epi16((short)v);         break;
+    case 4: vneedle = _mm256_set1_epi32((int)v);           break;
+    default: vneedle = _mm256_set1_epi64x((long long)v);
+    }
+
+    for (i = 0; i + lanes <= n; i += lanes) {
+        if (!(bits = __dzf_vec_avx2_match(data + i * elem_size,
+                                          vneedle, elem_size)))
+            continue;
+        if (!count_all)
+            return i + (size_t)__builtin_ctz(bits) / elem_size;
+        hits += (size_t)__builtin_popcount(bits) / elem_size;
+    }
+
+    if (count_all)
+        return hits + __dzf_vec_scan_scalar(data + i * elem_size, n - i,
+                                            elem_size, needle, TRUE);
+    return i + __dzf_vec_scan_scalar(data + i * elem_size, n - i,
+                                     elem_size, needle, FALSE);
+}
+#endif /* DZF_VEC_AVX2 */
+
+
+/* bytewise equality of elems of 1, 2, 4 or 8 bytes goes through SIMD */
+DZF_PRIVATE
+static inline size_t
+__dzf_vec_scan(void *self,
+               const void *value, Bool count_all)
+{
+    __dzf_vec_priv_void_t *vec = self;
+    size_t elem_size = __dzf_vec_get_elem_size(vec);
+    size_t n = __dzf_vec_get_length(vec);
+    uint64_t needle = 0;
+
+    switch (elem_size) {
+    case 1: case 2: case 4: case 8:
+        /* 'value' has only 'elem_size' bytes, the kernels read the copy */
+        memcpy(&needle, value, elem_size);
+#if defined(DZF_VEC_AVX2)
+        if (__builtin_cpu_supports("avx2"))
+            return __dzf_vec_scan_avx2(vec->data, n, elem_size,
+                                       &needle, count_all);
+#endif
+#if defined(DZF_VEC_SSE2)
+        return __dzf_vec_scan_sse2(vec->data, n, elem_size,
+                                   &needle, count_all);
+#else
+        return __dzf_vec_scan_scalar(vec->data, n, elem_size,
+                                     &needle, count_all);
+#endif
+    default:
+        return __dzf_vec_scan_bytes(vec->data, n, elem_size,
+                                    value, count_all);
+    }
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_vec_find(void *self,
+               const void *value)
+{
+    size_t idx = __dzf_vec_scan(self, value, FALSE);
+
+    return (idx < __dzf_vec_get_length(self)) ? idx : DZF_VEC_NPOS;
+}
+
 #endif /* DZF_VEC_PRIV_H */
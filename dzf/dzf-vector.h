@@ -30,9 +30,14 @@
  * Default capacity is '8' unless clarify the size via initializer.
  *
  * dzf_vec_t(T) has the following characteristics,
- * - automatically grow its size up to the 'current size * 2'.
- *
- * Note that it doesn't shrink its size although it is empty.
+ * - automatically grow its size up to the 'current size * 2' by default.
+ *   Use 'dzf_vec_set_growth' per instance, or define 'DZF_VEC_GROW_POLICY'
+ *   and 'DZF_VEC_GROW_ARG' at compile time to change the default.
+ * - 'dzf_vec_reserve' grows to an exact size ahead of time.
+ *
+ * Note that it doesn't shrink its size although it is empty, unless
+ * 'dzf_vec_shrink_to_fit' is called or auto-shrink is turned on by
+ * 'dzf_vec_set_auto_shrink'.
  */
 
 #ifndef DZF_VEC_H
@@ -56,7 +61,71 @@ dzf_vec_new_with(void *self,
 {
     __die(self);
 
-    return __dzf_vec_init(self, elem_size, capacity);
+    return __dzf_vec_init(self, elem_size, capacity, NULL);
+}
+
+/*!
+ * Initialize a vector whose buckets come from the allocator.
+ *
+ * @param self: a vector instance of dzf_vec_t(T).
+ * @param elem_size: each element size in byte unit.
+ * @param capacity: number of elements in the vector.
+ * @param allocator: an allocator that outlives the vector, NULL for default.
+ */
+DZF_PUBLIC
+static inline int
+dzf_vec_new_with_allocator(void *self,
+                           size_t elem_size, size_t capacity,
+                           const dzf_allocator_t *allocator)
+{
+    __die(self);
+
+    return __dzf_vec_init(self, elem_size, capacity, allocator);
+}
+
+/*!
+ * Initialize a vector whose buckets start on an 'align' boundary.
+ *
+ * The alignment is kept across growing and shrinking, so pass
+ * DZF_CACHELINE_SIZE to keep per-thread vectors off each other's cache
+ * lines or the SIMD width to use aligned loads on 'data'.
+ *
+ * @param self: a vector instance of dzf_vec_t(T).
+ * @param elem_size: each element size in byte unit.
+ * @param capacity: number of elements in the vector.
+ * @param align: a power of two in byte unit.
+ */
+DZF_PUBLIC
+static inline int
+dzf_vec_new_aligned(void *self,
+                    size_t elem_size, size_t capacity, size_t align)
+{
+    __die(self);
+    __die(align && !(align & (align - 1)));
+
+    return __dzf_vec_init_aligned(self, elem_size, capacity, NULL,
+                                  align < sizeof(void *) ? sizeof(void *) : align);
+}
+
+/*!
+ * Initialize a vector on caller-provided buckets.
+ *
+ * Nothing is allocated and 'buf' is never freed. Once the vector
+ * outgrows 'buf', its elems are copied out to the heap.
+ *
+ * @param self: a vector instance of dzf_vec_t(T).
+ * @param elem_size: each element size in byte unit.
+ * @param buf: buckets that outlive the vector, at least 'capacity' elems.
+ * @param capacity: number of elements 'buf' can hold.
+ */
+DZF_PUBLIC
+static inline int
+dzf_vec_init_with_buffer(void *self,
+                         size_t elem_size, void *buf, size_t capacity)
+{
+    __die(self);
+
+    return __dzf_vec_init_with_buffer(self, elem_size, buf, capacity);
 }
 
 /*!
@@ -72,7 +141,7 @@ dzf_vec_new(void *self,
 {
     __die(self);
 
-    return __dzf_vec_init(self, elem_size, DZF_VEC_ALLOC_SIZE);
+    return __dzf_vec_init(self, elem_size, DZF_VEC_ALLOC_SIZE, NULL);
 }
 
 /*!
@@ -114,7 +183,7 @@ dzf_vec_free(void *self)
  * @return the size of current used buckets.
  */
 DZF_PUBLIC
-static inline int
+static inline size_t
 dzf_vec_get_length(void *self)
 {
     __die(self);
@@ -129,7 +198,7 @@ dzf_vec_get_length(void *self)
  * @return the current capacity.
  */
 DZF_PUBLIC
-static inline int
+static inline size_t
 dzf_vec_get_capacity(void *self)
 {
     __die(self);
@@ -137,6 +206,102 @@ dzf_vec_get_capacity(void *self)
     return __dzf_vec_get_capacity(self);
 }
 
+/*!
+ * Get the number of allocated buckets of dzf_vec_t(T).
+ *
+ * @param self: a vector instance of dzf_vec_t(T).
+ * @return the number of allocated buckets.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_vec_get_alloc_size(void *self)
+{
+    __die(self);
+
+    return __dzf_vec_get_alloc_size(self);
+}
+
+/*!
+ * Set how dzf_vec_t(T) grows once it is full.
+ *
+ * - DZF_VEC_GROW_DEFAULT: follow 'DZF_VEC_GROW_POLICY', 'arg' is ignored.
+ * - DZF_VEC_GROW_DOUBLE: up to 'alloc_size * 2', 'arg' is ignored.
+ * - DZF_VEC_GROW_HALF: up to 'alloc_size * 1.5', 'arg' is ignored.
+ * - DZF_VEC_GROW_STEP: up to 'alloc_size + arg'.
+ * - DZF_VEC_GROW_CHUNK: up to 'alloc_size * 2', but 'arg' elems at most.
+ *
+ * @param self: a vector instance of dzf_vec_t(T).
+ * @param policy: one of DZF_VEC_GROW_*.
+ * @param arg: number of elems for the policy that needs it.
+ * @return none
+ */
+DZF_PUBLIC
+static inline void
+dzf_vec_set_growth(void *self,
+                   unsigned int policy, size_t arg)
+{
+    __die(self);
+    __die(policy <= DZF_VEC_GROW_CHUNK);
+    __die(policy != DZF_VEC_GROW_STEP || arg > 0);
+
+    __dzf_base_set_grow_policy(self, policy, arg);
+}
+
+/*!
+ * Reserve buckets of dzf_vec_t(T) for 'alloc_size' elems at least.
+ *
+ * It grows to 'alloc_size' exactly regardless of the growth policy,
+ * and does nothing if there are enough buckets already.
+ *
+ * @param self: a vector instance of dzf_vec_t(T).
+ * @param alloc_size: number of elems to hold without growing.
+ * @return the number of allocated buckets.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_vec_reserve(void *self,
+                size_t alloc_size)
+{
+    __die(self);
+
+    return __dzf_vec_reserve(self, alloc_size);
+}
+
+/*!
+ * Shrink the buckets of dzf_vec_t(T) down to its length.
+ *
+ * @param self: a vector instance of dzf_vec_t(T).
+ * @return the number of allocated buckets.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_vec_shrink_to_fit(void *self)
+{
+    __die(self);
+
+    return __dzf_vec_shrink_to(self, __dzf_vec_get_length(self));
+}
+
+/*!
+ * Turn auto-shrink of dzf_vec_t(T) on or off.
+ *
+ * Once on, removing an elem halves the buckets when less than a quarter
+ * of them is in use, but never below the default capacity, '8'.
+ *
+ * @param self: a vector instance of dzf_vec_t(T).
+ * @param auto_shrink: TRUE to turn on, FALSE to turn off.
+ * @return none
+ */
+DZF_PUBLIC
+static inline void
+dzf_vec_set_auto_shrink(void *self,
+                        Bool auto_shrink)
+{
+    __die(self);
+
+    __dzf_base_toggle_flag(self, DZF_BASE_FLAG_AUTO_SHRINK, auto_shrink);
+}
+
 /*!
  * Is dzf_vec_t(T) full?
  *
@@ -316,7 +481,7 @@ DZF_PUBLIC
  */
 DZF_PUBLIC
 #define dzf_vec_add_at(self, _idx, _val) \
-    ( assert(0 <= _idx && _idx <= __dzf_vec_get_alloc_size(self)), \
+    ( __die(__dzf_vec_insert_validator(self, _idx)), \
       __dzf_vec_insert_at(self, _idx, _val) )
 
 /*!
@@ -330,7 +495,7 @@ DZF_PUBLIC
  */
 DZF_PUBLIC
 #define dzf_ved_add_head(self, val) \
-    dzf_vec_add_at(self, 0, val)
+    __dzf_vec_insert_at(self, 0, val)
 
 /*!
  * Add a new value at the tail of dzf_vec_t(T).
@@ -383,12 +548,183 @@ DZF_PUBLIC
 #define dzf_vec_rmv_tail(self) \
     dzf_vec_rmv_at(self, __dzf_vec_get_length(self)-1)
 
+/*!
+ * Insert 'n' values from an array at the index of dzf_vec_t(T).
+ *
+ * It grows at most once and shifts the tail once for all values.
+ *
+ * @param self: a vector instance of dzf_vec_t(T).
+ * @param index: an index to store the first value, up to the length.
+ * @param src: an array of T that holds 'n' values.
+ * @param n: number of values to insert.
+ * @return none.
+ */
+DZF_PUBLIC
+static inline void
+dzf_vec_insert_range(void *self,
+                     size_t index, const void *src, size_t n)
+{
+    __die(self);
+    __die(src || n == 0);
+    __die(index <= __dzf_vec_get_length(self));
+
+    /* nothing to copy, and memcpy from NULL is undefined even for 0 */
+    if (n == 0)
+        return;
+
+    __dzf_vec_insert_range(self, index, src, n);
+}
+
+/*!
+ * Append 'n' values from an array at the tail of dzf_vec_t(T).
+ *
+ * @param self: a vector instance of dzf_vec_t(T).
+ * @param src: an array of T that holds 'n' values.
+ * @param n: number of values to append.
+ * @return none.
+ */
+DZF_PUBLIC
+static inline void
+dzf_vec_append_array(void *self,
+                     const void *src, size_t n)
+{
+    __die(self);
+    __die(src || n == 0);
+
+    if (n == 0)
+        return;
+
+    __dzf_vec_insert_range(self, __dzf_vec_get_length(self), src, n);
+}
+
+/*!
+ * Remove 'n' values from the index of dzf_vec_t(T).
+ *
+ * It shifts the tail once for all values.
+ *
+ * @param self: a vector instance of dzf_vec_t(T).
+ * @param index: an index to the first value to remove.
+ * @param n: number of values to remove.
+ * @return none.
+ */
+DZF_PUBLIC
+static inline void
+dzf_vec_erase_range(void *self,
+                    size_t index, size_t n)
+{
+    __die(self);
+    __die(index <= __dzf_vec_get_length(self));
+    __die(n <= __dzf_vec_get_length(self) - index);
+
+    __dzf_vec_erase_range(self, index, n);
+}
+
+/*!
+ * Remove a value at the index of dzf_vec_t(T) without keeping the order.
+ *
+ * The last value is moved into the hole, so that this is O(1).
+ *
+ * @param self: a vector instance of dzf_vec_t(T).
+ * @param index: an index to the value to remove.
+ * @return none.
+ */
+DZF_PUBLIC
+static inline void
+dzf_vec_swap_remove_at(void *self,
+                       size_t index)
+{
+    __die(self);
+    __die(index < __dzf_vec_get_length(self));
+
+    __dzf_vec_swap_remove_at(self, index);
+}
+
+/*!
+ * Keep only the values of dzf_vec_t(T) that satisfy the predicate.
+ *
+ * It removes the rest in one linear sweep and keeps the order.
+ *
+ * @param self: a vector instance of dzf_vec_t(T).
+ * @param pred: returns TRUE to keep the elem, a pointer to T.
+ * @param user_data: passed to 'pred' as it is.
+ * @return number of values removed.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_vec_retain_if(void *self,
+                  Bool (*pred)(const void *elem, void *user_data),
+                  void *user_data)
+{
+    __die(self);
+    __die(pred);
+
+    return __dzf_vec_retain_if(self, pred, user_data);
+}
+
+/*!
+ * Find the first value equal to '*value' in dzf_vec_t(T).
+ *
+ * Values are compared bytewise, so padding bytes of T count and
+ * '-0.0' differs from '0.0'. Elems of 1, 2, 4 or 8 bytes are scanned
+ * with SSE2/AVX2 where available.
+ *
+ * @param self: a vector instance of dzf_vec_t(T).
+ * @param value: a pointer to T to look for.
+ * @return index of the value, DZF_VEC_NPOS if not found.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_vec_find(void *self,
+             const void *value)
+{
+    __die(self);
+    __die(value);
+
+    return __dzf_vec_find(self, value);
+}
+
+/*!
+ * Count values equal to '*value' in dzf_vec_t(T), like dzf_vec_find.
+ *
+ * @param self: a vector instance of dzf_vec_t(T).
+ * @param value: a pointer to T to look for.
+ * @return number of the values.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_vec_count(void *self,
+              const void *value)
+{
+    __die(self);
+    __die(value);
+
+    return __dzf_vec_scan(self, value, TRUE);
+}
+
+/*!
+ * Check if dzf_vec_t(T) has a value equal to '*value', like dzf_vec_find.
+ *
+ * @param self: a vector instance of dzf_vec_t(T).
+ * @param value: a pointer to T to look for.
+ * @return TRUE if found, otherwise FALSE.
+ */
+DZF_PUBLIC
+static inline Bool
+dzf_vec_contains(void *self,
+                 const void *value)
+{
+    __die(self);
+    __die(value);
+
+    return (__dzf_vec_find(self, value) != DZF_VEC_NPOS) ? TRUE : FALSE;
+}
+
 /*!
  * Walk through all elements in dzf_vec_t(T).
  *
  * @param elem: a pointer to the type of element of dzf_vec_t(T).
  * @param self: a vector instance of dzf_vec_t(T).
- * @param idx_var: an integer type variable.
+ * @param idx_var: a size_t type variable.
  */
 DZF_PUBLIC
 #define dzf_vec_for_each(elem, self, idx_var) \
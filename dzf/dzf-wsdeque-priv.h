@@ -0,0 +1,317 @@
+/* dzf-wsdeque-priv.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef DZF_WSDEQUE_PRIV_H
+#define DZF_WSDEQUE_PRIV_H
+
+#if !defined (DZF_WSDEQUE_USE_AS_PRIVATE)
+#   error "Only <dzf/dzf-wsdeque.h> can be included directly!"
+#endif
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "dzf-util.h"
+
+#define DZF_BASE_USE_AS_PRIVATE
+#include "dzf-base.h"
+#undef  DZF_BASE_USE_AS_PRIVATE
+
+/*
+ * A circular array of word-sized slots. Each slot is atomic, so that
+ * thieves may read it while the owner writes another lap of the ring.
+ * Outgrown rings are kept on 'next' until the deque is freed, since a
+ * slow thief may still be reading one.
+ */
+typedef struct __dzf_wsdeque_ring {
+    size_t size;
+    struct __dzf_wsdeque_ring *next;
+    atomic_uint_least64_t slots[];
+} __dzf_wsdeque_ring_t;
+
+/* -- Type Definition -- */
+/*!
+ * @def dzf_wsdeque_t(T)
+ * @brief Work-stealing deque type
+ *
+ * @param T: type of elems, no larger than 8 bytes, e.g. a task pointer.
+ *
+ * The owner works at 'bottom' and thieves race for 'top', each one on
+ * its own cache line.
+ *
+ * \b Examples
+ * @code{.c}
+ *   typedef dzf_wsdeque_t(struct task *) wsdeque_task_t;
+ * @endcode
+ */
+#define dzf_wsdeque_t(T) \
+    struct { \
+        __dzf_base_t _unused1; \
+        _Alignas(DZF_CACHELINE_SIZE) atomic_size_t top; \
+        _Alignas(DZF_CACHELINE_SIZE) atomic_size_t bottom; \
+        _Atomic(__dzf_wsdeque_ring_t *) ring; \
+        T hold_elem; \
+    }
+
+typedef dzf_wsdeque_t(void*)     __dzf_wsdeque_priv_void_t;
+#define DZF_WSDEQUE_VOID(self)   ((__dzf_wsdeque_priv_void_t*)self)
+
+#define DZF_WSDEQUE_ALLOC_SIZE 256 /* default capacity, must be a power of two */
+
+
+/* -- Private APIs -- */
+DZF_PRIVATE
+static inline size_t
+__dzf_wsdeque_elem_size(void *self)
+{
+    return __dzf_base_get_elem_size(self);
+}
+
+
+DZF_PRIVATE
+static inline __dzf_wsdeque_ring_t *
+__dzf_wsdeque_ring_new(void *self,
+                       size_t size)
+{
+    __dzf_wsdeque_ring_t *ring;
+    size_t i;
+
+    ring = __dzf_base_alloc_array(self, 1, sizeof(*ring)
+                                  + dzf_mul_size(size, sizeof(ring->slots[0])));
+    ring->size = size;
+    ring->next = NULL;
+    for (i = 0; i < size; i++)
+        atomic_init(&ring->slots[i], 0);
+
+    return ring;
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_wsdeque_ring_free(void *self,
+                        __dzf_wsdeque_ring_t *ring)
+{
+    __dzf_base_free_array(self, ring, 1,
+                          sizeof(*ring) + ring->size * sizeof(ring->slots[0]));
+}
+
+
+DZF_PRIVATE
+static inline uint_least64_t
+__dzf_wsdeque_ring_get(__dzf_wsdeque_ring_t *ring,
+                       size_t index)
+{
+    return atomic_load_explicit(&ring->slots[index & (ring->size - 1)],
+                                memory_order_relaxed);
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_wsdeque_ring_put(__dzf_wsdeque_ring_t *ring,
+                       size_t index, uint_least64_t word)
+{
+    atomic_store_explicit(&ring->slots[index & (ring->size - 1)], word,
+                          memory_order_relaxed);
+}
+
+
+/* owner side, double the ring and keep the old one for slow thieves */
+DZF_PRIVATE
+static inline __dzf_wsdeque_ring_t *
+__dzf_wsdeque_grow(void *self,
+                   __dzf_wsdeque_ring_t *ring, size_t top, size_t bottom)
+{
+    __dzf_wsdeque_priv_void_t *dq = self;
+    __dzf_wsdeque_ring_t *bigger = __dzf_wsdeque_ring_new(dq, ring->size * 2);
+    size_t i;
+
+    for (i = top; i != bottom; i++)
+        __dzf_wsdeque_ring_put(bigger, i, __dzf_wsdeque_ring_get(ring, i));
+    bigger->next = ring;
+
+    atomic_store_explicit(&dq->ring, bigger, memory_order_release);
+    __dzf_base_set_capacity(dq, bigger->size);
+
+    return bigger;
+}
+
+
+/* owner side */
+DZF_PRIVATE
+static inline void
+__dzf_wsdeque_push(void *self,
+                   const void *elem)
+{
+    __dzf_wsdeque_priv_void_t *dq = self;
+    size_t b = atomic_load_explicit(&dq->bottom, memory_order_relaxed);
+    size_t t = atomic_load_explicit(&dq->top, memory_order_acquire);
+    __dzf_wsdeque_ring_t *ring;
+    uint_least64_t word = 0;
+
+    ring = atomic_load_explicit(&dq->ring, memory_order_relaxed);
+    if (b - t > ring->size - 1)
+        ring = __dzf_wsdeque_grow(dq, ring, t, b);
+
+    memcpy(&word, elem, __dzf_wsdeque_elem_size(dq));
+    __dzf_wsdeque_ring_put(ring, b, word);
+
+    /* publish the elem before the new bottom */
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+}
+
+
+/* owner side, LIFO */
+DZF_PRIVATE
+static inline Bool
+__dzf_wsdeque_pop(void *self,
+                  void *out)
+{
+    __dzf_wsdeque_priv_void_t *dq = self;
+    size_t b = atomic_load_explicit(&dq->bottom, memory_order_relaxed) - 1;
+    __dzf_wsdeque_ring_t *ring;
+    uint_least64_t word;
+    size_t t;
+    Bool ok = TRUE;
+
+    ring = atomic_load_explicit(&dq->ring, memory_order_relaxed);
+    atomic_store_explicit(&dq->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    t = atomic_load_explicit(&dq->top, memory_order_relaxed);
+
+    if ((ptrdiff_t)(b - t) < 0) {
+        /* empty, restore the bottom */
+        atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+        return FALSE;
+    }
+
+    word = __dzf_wsdeque_ring_get(ring, b);
+    if (t == b) {
+        /* the last elem, race thieves for it */
+        if (!atomic_compare_exchange_strong_explicit(&dq->top, &t, t + 1,
+                                                     memory_order_seq_cst,
+                                                     memory_order_relaxed))
+            ok = FALSE;
+        atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+    }
+
+    if (ok)
+        memcpy(out, &word, __dzf_wsdeque_elem_size(dq));
+
+    return ok;
+}
+
+
+/* thief side, FIFO, fails on empty or when another one wins the race */
+DZF_PRIVATE
+static inline Bool
+__dzf_wsdeque_steal(void *self,
+                    void *out)
+{
+    __dzf_wsdeque_priv_void_t *dq = self;
+    size_t t = atomic_load_explicit(&dq->top, memory_order_acquire);
+    __dzf_wsdeque_ring_t *ring;
+    uint_least64_t word;
+    size_t b;
+
+    atomic_thread_fence(memory_order_seq_cst);
+    b = atomic_load_explicit(&dq->bottom, memory_order_acquire);
+
+    if ((ptrdiff_t)(b - t) <= 0)
+        return FALSE;
+
+    ring = atomic_load_explicit(&dq->ring, memory_order_acquire);
+    word = __dzf_wsdeque_ring_get(ring, t);
+    if (!atomic_compare_exchange_strong_explicit(&dq->top, &t, t + 1,
+                                                 memory_order_seq_cst,
+                                                 memory_order_relaxed))
+        return FALSE;
+
+    memcpy(out, &word, __dzf_wsdeque_elem_size(dq));
+
+    return TRUE;
+}
+
+
+DZF_PRIVATE
+static inline size_t
+__dzf_wsdeque_size(void *self)
+{
+    __dzf_wsdeque_priv_void_t *dq = self;
+    size_t b = atomic_load_explicit(&dq->bottom, memory_order_acquire);
+    size_t t = atomic_load_explicit(&dq->top, memory_order_acquire);
+
+    /* a snapshot, it may be stale as soon as it returns */
+    return (ptrdiff_t)(b - t) > 0 ? b - t : 0;
+}
+
+
+DZF_PRIVATE
+static inline int
+__dzf_wsdeque_init(void *self,
+                   size_t elem_size, size_t capacity,
+                   const dzf_allocator_t *allocator)
+{
+    __dzf_wsdeque_priv_void_t *dq = self;
+
+    /* elems travel through word-sized atomic slots */
+    __die(elem_size <= sizeof(uint_least64_t));
+
+    if (capacity <= DZF_WSDEQUE_ALLOC_SIZE)
+        capacity = DZF_WSDEQUE_ALLOC_SIZE;
+    capacity = dzf_next_pow2(capacity);
+
+    __dzf_base_init(dq, 0, capacity, elem_size);
+    if (allocator)
+        __dzf_base_set_allocator(dq, allocator);
+    atomic_init(&dq->top, 0);
+    atomic_init(&dq->bottom, 0);
+    atomic_init(&dq->ring, __dzf_wsdeque_ring_new(dq, capacity));
+
+    return 0;
+}
+
+
+DZF_PRIVATE
+static inline void
+__dzf_wsdeque_data_free(void *self)
+{
+    __dzf_wsdeque_priv_void_t *dq = self;
+    __dzf_wsdeque_ring_t *ring, *next;
+
+    ring = atomic_load_explicit(&dq->ring, memory_order_relaxed);
+    for (; ring != NULL; ring = next) {
+        next = ring->next;
+        __dzf_wsdeque_ring_free(dq, ring);
+    }
+    atomic_init(&dq->ring, NULL);
+    atomic_init(&dq->top, 0);
+    atomic_init(&dq->bottom, 0);
+    __dzf_base_init(dq, 0, 0, 0);
+}
+
+#endif /* DZF_WSDEQUE_PRIV_H */
@@ -0,0 +1,216 @@
+/* dzf-wsdeque.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! @file dzf-wsdeque.h
+ *
+ * @brief Work-Stealing Deque Type Structure.
+ *
+ * dzf_wsdeque_t(T) is a Chase-Lev deque for task schedulers. The one
+ * thread that owns it pushes and pops at the bottom, LIFO, and any other
+ * thread may steal from the top, FIFO, all without any lock. Default
+ * capacity is '256' unless clarify it via initializer, and it is always
+ * rounded up to a power of two.
+ *
+ * The owner takes no read-modify-write atomic but to race thieves for
+ * the very last elem, and the ring doubles once it is full. Outgrown
+ * rings are given back only by 'data_free'. Thieves fail instead of
+ * retrying when another thread wins the race.
+ *
+ * Elems travel through word-sized atomic slots, so that T must be no
+ * larger than 8 bytes, e.g. a pointer to a task. It requires a C11
+ * compiler for atomics.
+ *
+ * Note that neither of initializers nor 'data_free' is thread-safe.
+ *
+ * \b Examples
+ * @code{.c}
+ *   dzf_wsdeque_t(struct task *) dq;
+ *   struct task *t;
+ *
+ *   dzf_wsdeque_new(&dq, sizeof(struct task *));
+ *   dzf_wsdeque_push(&dq, task);            // owner
+ *   if (dzf_wsdeque_pop(&dq, &t)) ...       // owner
+ *   if (dzf_wsdeque_steal(&dq, &t)) ...     // any other thread
+ *   dzf_wsdeque_data_free(&dq);
+ * @endcode
+ */
+
+#ifndef DZF_WSDEQUE_H
+#define DZF_WSDEQUE_H
+
+#define DZF_WSDEQUE_USE_AS_PRIVATE
+#include "dzf-wsdeque-priv.h"
+
+
+/*!
+ * Initialize a dzf_wsdeque_t(T) instance whose rings come from the
+ * allocator.
+ *
+ * @param self: an instance of dzf_wsdeque_t(T).
+ * @param elem_size: each element size in byte unit, 8 at most.
+ * @param capacity: number of elements in the first ring.
+ * @param allocator: a thread-safe allocator that outlives the deque,
+ *                   NULL for default.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_wsdeque_init_with_allocator(void *self,
+                                size_t elem_size, size_t capacity,
+                                const dzf_allocator_t *allocator)
+{
+    __die(self);
+
+    return __dzf_wsdeque_init(self, elem_size, capacity, allocator);
+}
+
+/*!
+ * Initialize a dzf_wsdeque_t(T) instance.
+ *
+ * @param self: an instance of dzf_wsdeque_t(T).
+ * @param elem_size: each element size in byte unit, 8 at most.
+ * @param capacity: number of elements in the first ring.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_wsdeque_init(void *self,
+                 size_t elem_size, size_t capacity)
+{
+    __die(self);
+
+    return __dzf_wsdeque_init(self, elem_size, capacity, NULL);
+}
+
+/*!
+ * Initialize a dzf_wsdeque_t(T) instance with capacity '256'.
+ *
+ * @param self: an instance of dzf_wsdeque_t(T).
+ * @param elem_size: each element size in byte unit, 8 at most.
+ * @return 0 on success.
+ */
+DZF_PUBLIC
+static inline int
+dzf_wsdeque_new(void *self,
+                size_t elem_size)
+{
+    __die(self);
+
+    return __dzf_wsdeque_init(self, elem_size, DZF_WSDEQUE_ALLOC_SIZE, NULL);
+}
+
+/*!
+ * Free all rings of dzf_wsdeque_t(T).
+ *
+ * @param self: an instance of dzf_wsdeque_t(T).
+ * @return none
+ */
+DZF_PUBLIC
+static inline void
+dzf_wsdeque_data_free(void *self)
+{
+    __die(self);
+
+    __dzf_wsdeque_data_free(self);
+}
+
+/*!
+ * Get the number of elems in dzf_wsdeque_t(T).
+ *
+ * Note that it is a snapshot under concurrent access.
+ *
+ * @param self: an instance of dzf_wsdeque_t(T).
+ * @return the number of elems.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_wsdeque_size(void *self)
+{
+    __die(self);
+
+    return __dzf_wsdeque_size(self);
+}
+
+/*!
+ * Get the capacity of the current ring, owner side only.
+ *
+ * @param self: an instance of dzf_wsdeque_t(T).
+ * @return the capacity.
+ */
+DZF_PUBLIC
+static inline size_t
+dzf_wsdeque_capacity(void *self)
+{
+    __die(self);
+
+    return __dzf_base_get_capacity(self);
+}
+
+/*!
+ * Push a value at the bottom of dzf_wsdeque_t(T), owner side only.
+ *
+ * @param self: an instance of dzf_wsdeque_t(T).
+ * @param value: a new value.
+ * @return none
+ */
+DZF_PUBLIC
+#define dzf_wsdeque_push(self, value) \
+    ( \
+      __die(self), \
+      (self)->hold_elem = (value), \
+      __dzf_wsdeque_push(self, &(self)->hold_elem) \
+    )
+
+/*!
+ * Pop the latest value from the bottom of dzf_wsdeque_t(T), owner side
+ * only.
+ *
+ * @param self: an instance of dzf_wsdeque_t(T).
+ * @param out: a pointer to T that receives the value.
+ * @return TRUE on success, FALSE if empty.
+ */
+DZF_PUBLIC
+#define dzf_wsdeque_pop(self, out) \
+    ( \
+      __die(self), \
+      __die(sizeof(*(out)) == sizeof((self)->hold_elem)), \
+      __dzf_wsdeque_pop(self, out) \
+    )
+
+/*!
+ * Steal the oldest value from the top of dzf_wsdeque_t(T).
+ *
+ * @param self: an instance of dzf_wsdeque_t(T).
+ * @param out: a pointer to T that receives the value.
+ * @return TRUE on success, FALSE if empty or another thread won it.
+ */
+DZF_PUBLIC
+#define dzf_wsdeque_steal(self, out) \
+    ( \
+      __die(self), \
+      __die(sizeof(*(out)) == sizeof((self)->hold_elem)), \
+      __dzf_wsdeque_steal(self, out) \
+    )
+
+#endif /* DZF_WSDEQUE_H */
@@ -35,8 +35,22 @@ int
 main(int argc, char **argv)
 {
     vector_main();
+    smallvec_main();
     stack_main();
     queue_main();
+    spsc_queue_main();
+    mpmc_queue_main();
+    allocator_main();
+    arena_main();
+    pool_main();
+    hmap_main();
+    hset_main();
+    pq_main();
+    deque_main();
+    wsdeque_main();
+    cstack_main();
+    magazine_main();
+    sort_main();
 
     return 0;
 }
@@ -32,5 +32,23 @@
 void vector_main(void);
 void stack_main(void);
 void queue_main(void);
+void spsc_queue_main(void);
+void mpmc_queue_main(void);
+void allocator_main(void);
+void arena_main(void);
+void pool_main(void);
+void smallvec_main(void);
+void hmap_main(void);
+void hset_main(void);
+void pq_main(void);
+void deque_main(void);
+void wsdeque_main(void);
+void cstack_main(void);
+void magazine_main(void);
+void sort_main(void);
+
+/* test_allocator_default.c */
+void allocator_default_vec_new(void *vec, size_t elem_size);
+size_t allocator_default_bytes(void);
 
 #endif
@@ -0,0 +1,137 @@
+/* test_allocator.c
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "test.h"
+
+#include <dzf/dzf-vector.h>
+#include <dzf/dzf-stack.h>
+#include <dzf/dzf-queue.h>
+
+struct counter {
+    size_t nr_allocs;
+    size_t nr_frees;
+    size_t bytes;   /* in use */
+};
+
+static void allocator_counting(void);
+static void allocator_default_unit(void);
+
+void
+allocator_main(void)
+{
+    border("ALLOCATOR");
+    allocator_counting();
+
+    border("ALLOCATOR DEFAULT");
+    allocator_default_unit();
+}
+
+
+static void *
+counting_alloc(void *ctx, size_t size)
+{
+    struct counter *cnt = ctx;
+
+    cnt->nr_allocs++;
+    cnt->bytes += size;
+
+    return malloc(size);
+}
+
+static void *
+counting_realloc(void *ctx, void *ptr, size_t old_size, size_t new_size)
+{
+    struct counter *cnt = ctx;
+
+    cnt->bytes += new_size - old_size;
+
+    return realloc(ptr, new_size);
+}
+
+static void
+counting_free(void *ctx, void *ptr, size_t size)
+{
+    struct counter *cnt = ctx;
+
+    cnt->nr_frees++;
+    cnt->bytes -= size;
+
+    free(ptr);
+}
+
+/* Test that every container goes through the allocator */
+static void
+allocator_counting(void)
+{
+    struct counter cnt = { 0, 0, 0 };
+    const dzf_allocator_t allocator = {
+        counting_alloc, counting_realloc, counting_free, &cnt
+    };
+    dzf_vec_t(int) vec;
+    dzf_stack_t(int) stack;
+    dzf_queue_t(int) queue;
+    int i;
+
+    dzf_vec_new_with_allocator(&vec, sizeof(int), 8, &allocator);
+    dzf_stack_init_with_allocator(&stack, sizeof(int), 16, &allocator);
+    dzf_queue_init_with_allocator(&queue, sizeof(int), 16, &allocator);
+    dzf_queue_set_growable(&queue, TRUE);
+    assert(cnt.nr_allocs == 3);
+    assert(cnt.bytes == (8 + 16 + 16) * sizeof(int));
+
+    for (i = 0; i < 100; i++) {
+        dzf_vec_add_tail(&vec, i);
+        dzf_stack_push(&stack, i);
+        dzf_queue_enq(&queue, i);
+    }
+    assert(cnt.bytes == (128 + 128 + 128) * sizeof(int));
+
+    dzf_vec_shrink_to_fit(&vec);
+    assert(cnt.bytes == (100 + 128 + 128) * sizeof(int));
+
+    dzf_vec_data_free(&vec);
+    dzf_stack_data_free(&stack);
+    dzf_queue_data_free(&queue);
+    assert(cnt.nr_frees == 3);
+    assert(cnt.bytes == 0);
+}
+
+/* Test that the default allocator sticks to the unit that initializes */
+static void
+allocator_default_unit(void)
+{
+    dzf_vec_t(int) vec;
+    int i;
+
+    allocator_default_vec_new(&vec, sizeof(int));
+    assert(allocator_default_bytes() == 8 * sizeof(int));
+
+    /* this unit has no default, yet grows and frees through that one */
+    for (i = 0; i < 100; i++)
+        dzf_vec_add_tail(&vec, i);
+    assert(allocator_default_bytes() == 128 * sizeof(int));
+
+    dzf_vec_data_free(&vec);
+    assert(allocator_default_bytes() == 0);
+}
@@ -0,0 +1,79 @@
+/* test_allocator_default.c
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * A unit with its own default allocator, whose containers are grown and
+ * freed from units without one in test_allocator.c.
+ */
+
+#include "test.h"
+
+#include <stdlib.h>
+
+#define DZF_DEFAULT_ALLOCATOR (&default_allocator)
+#include <dzf/dzf-allocator.h>
+
+static size_t default_bytes;  /* in use */
+
+static void *
+default_alloc(void *ctx, size_t size)
+{
+    default_bytes += size;
+
+    return malloc(size);
+}
+
+static void *
+default_realloc(void *ctx, void *ptr, size_t old_size, size_t new_size)
+{
+    default_bytes += new_size - old_size;
+
+    return realloc(ptr, new_size);
+}
+
+static void
+default_free(void *ctx, void *ptr, size_t size)
+{
+    default_bytes -= size;
+
+    free(ptr);
+}
+
+static const dzf_allocator_t default_allocator = {
+    default_alloc, default_realloc, default_free, NULL
+};
+
+#include <dzf/dzf-vector.h>
+
+void
+allocator_default_vec_new(void *vec, size_t elem_size)
+{
+    dzf_vec_new(vec, elem_size);
+}
+
+size_t
+allocator_default_bytes(void)
+{
+    return default_bytes;
+}
@@ -0,0 +1,110 @@
+/* test_arena.c
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "test.h"
+
+#include <stdint.h>
+
+#include <dzf/dzf-arena.h>
+#include <dzf/dzf-vector.h>
+#include <dzf/dzf-stack.h>
+
+static void arena_blocks(void);
+static void arena_containers(void);
+
+void
+arena_main(void)
+{
+    border("ARENA BLOCKS");
+    arena_blocks();
+
+    border("ARENA CONTAINERS");
+    arena_containers();
+}
+
+
+/* Test for raw blocks */
+static void
+arena_blocks(void)
+{
+    dzf_arena_t arena;
+    char *a, *b, *c;
+
+    dzf_arena_init(&arena, 256);
+
+    a = dzf_arena_alloc(&arena, 3);
+    b = dzf_arena_alloc(&arena, 100);
+    assert(((uintptr_t)a % DZF_ARENA_ALIGN) == 0);
+    assert(((uintptr_t)b % DZF_ARENA_ALIGN) == 0);
+    assert(b == a + DZF_ARENA_ALIGN);
+
+    /* bigger than a chunk */
+    c = dzf_arena_alloc(&arena, 1000);
+    memset(c, 0xff, 1000);
+
+    dzf_arena_reset(&arena);
+    assert(dzf_arena_alloc(&arena, 3) == a);
+
+    dzf_arena_release(&arena);
+}
+
+
+/* Test for containers built against the arena */
+static void
+arena_containers(void)
+{
+    dzf_arena_t arena;
+    dzf_vec_t(int) vec;
+    dzf_stack_t(long) stack;
+    void *first_data = NULL;
+    int round, i;
+
+    dzf_arena_init(&arena, 0);
+
+    for (round = 0; round < 3; round++) {
+        dzf_vec_new_with_allocator(&vec, sizeof(int), 8,
+                                   dzf_arena_allocator(&arena));
+        dzf_stack_init_with_allocator(&stack, sizeof(long), 16,
+                                      dzf_arena_allocator(&arena));
+
+        /* chunks are reused after reset */
+        if (round == 0)
+            first_data = vec.data;
+        assert(vec.data == first_data);
+
+        for (i = 0; i < 1000; i++) {
+            dzf_vec_add_tail(&vec, i);
+            dzf_stack_push(&stack, (long)i);
+        }
+        for (i = 0; i < 1000; i++)
+            assert(dzf_vec_get_value(&vec, i) == i);
+        for (i = 999; i >= 0; i--)
+            assert(dzf_stack_pop(&stack) == i);
+
+        /* a single reset tears them all down */
+        dzf_arena_reset(&arena);
+    }
+
+    dzf_arena_release(&arena);
+}
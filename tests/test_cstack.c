@@ -0,0 +1,166 @@
+/* test_cstack.c
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "test.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include <dzf/dzf-cstack.h>
+
+typedef dzf_cstack_t(long) cstack_long_t;
+
+static void cstack_long_type(void);
+static void cstack_threads(void);
+static void cstack_aligned_type(void);
+
+void
+cstack_main(void)
+{
+    border("CSTACK");
+    cstack_long_type();
+
+    border("CSTACK THREADS");
+    cstack_threads();
+
+    border("CSTACK ALIGNED TYPE");
+    cstack_aligned_type();
+}
+
+
+/* Test for long type in a single thread */
+static void
+cstack_long_type(void)
+{
+    cstack_long_t cs;
+    long i, val;
+
+    dzf_cstack_new(&cs, sizeof(long));
+    assert(dzf_cstack_try_pop(&cs, &val) == FALSE);
+
+    /* spill over a few chunks */
+    for (i = 0; i < 1000; i++)
+        dzf_cstack_push(&cs, &i);
+    assert(dzf_cstack_size(&cs) == 1000);
+    for (i = 999; i >= 0; i--)
+        assert(dzf_cstack_try_pop(&cs, &val) == TRUE && val == i);
+    assert(dzf_cstack_try_pop(&cs, &val) == FALSE);
+
+    /* freed nodes are reused rather than new ones */
+    for (i = 0; i < 1000; i++)
+        dzf_cstack_push(&cs, &i);
+    assert(atomic_load(&cs.fresh) == 1000);
+
+    dzf_cstack_data_free(&cs);
+}
+
+
+/* Test for threads recycling values through the stack */
+#define CSTACK_NR_THREADS 4
+#define CSTACK_NR_ITEMS 100000L
+#define CSTACK_NR_ROUNDS 4
+
+static cstack_long_t c_stack;
+static atomic_uchar c_taken[CSTACK_NR_ITEMS];   /* times each value is drained */
+
+static void *
+cstack_worker(void *arg)
+{
+    long i, r, val;
+
+    (void)arg;
+
+    /* pop what is there and push it back, contending for the same nodes */
+    for (r = 0; r < CSTACK_NR_ROUNDS; r++)
+        for (i = 0; i < CSTACK_NR_ITEMS; i++) {
+            if (dzf_cstack_try_pop(&c_stack, &val))
+                dzf_cstack_push(&c_stack, &val);
+            assert(dzf_cstack_size(&c_stack) <= CSTACK_NR_ITEMS);
+        }
+
+    /* then drain it */
+    while (dzf_cstack_try_pop(&c_stack, &val)) {
+        assert(val >= 0 && val < CSTACK_NR_ITEMS);
+        atomic_fetch_add_explicit(&c_taken[val], 1, memory_order_relaxed);
+    }
+
+    return NULL;
+}
+
+static void
+cstack_threads(void)
+{
+    pthread_t workers[CSTACK_NR_THREADS];
+    long n = CSTACK_NR_ITEMS;
+    long i;
+
+    dzf_cstack_new(&c_stack, sizeof(long));
+    for (i = 0; i < n; i++) {
+        atomic_init(&c_taken[i], 0);
+        dzf_cstack_push(&c_stack, &i);
+    }
+
+    for (i = 0; i < CSTACK_NR_THREADS; i++)
+        pthread_create(&workers[i], NULL, cstack_worker, NULL);
+    for (i = 0; i < CSTACK_NR_THREADS; i++)
+        pthread_join(workers[i], NULL);
+
+    /* every value in [0, n) has survived the recycling exactly once */
+    for (i = 0; i < n; i++)
+        assert(atomic_load(&c_taken[i]) == 1);
+    assert(dzf_cstack_size(&c_stack) == 0);
+    printf("%ld items have been recycled.\n", n);
+
+    dzf_cstack_data_free(&c_stack);
+}
+
+
+/* Test for elems aligned past the 8 bytes of the node link */
+struct cstack_blk {
+    _Alignas(32) long v;
+    char pad[40];
+};
+
+static void
+cstack_aligned_type(void)
+{
+    dzf_cstack_t(struct cstack_blk) cs;
+    struct cstack_blk blk;
+    uint_least32_t n;
+    long i;
+
+    dzf_cstack_init(&cs, sizeof(blk), 4);
+    memset(&blk, 0, sizeof(blk));
+    for (i = 0; i < 200; i++) {
+        blk.v = i;
+        dzf_cstack_push(&cs, &blk);
+    }
+    for (n = 1; n <= 200; n++)
+        assert((uintptr_t)__dzf_cstack_node_elem(&cs, __dzf_cstack_node(&cs, n))
+               % _Alignof(struct cstack_blk) == 0);
+    for (i = 199; i >= 0; i--)
+        assert(dzf_cstack_try_pop(&cs, &blk) == TRUE && blk.v == i);
+
+    dzf_cstack_data_free(&cs);
+}
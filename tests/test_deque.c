@@ -0,0 +1,118 @@
+/* test_deque.c
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "test.h"
+
+#include <dzf/dzf-deque.h>
+
+static void deque_int_type(void);
+static void deque_sliding_window(void);
+
+void
+deque_main(void)
+{
+    border("DEQUE INT TYPE");
+    deque_int_type();
+
+    border("DEQUE SLIDING WINDOW");
+    deque_sliding_window();
+}
+
+
+static void
+deque_int_print(const int *item, ...)
+{
+    printf("%d ", *item);
+}
+
+
+/* Test for int type */
+static void
+deque_int_type(void)
+{
+    typedef dzf_deque_t(int) deque_int_t;
+    deque_int_t dq;
+    int i;
+
+    dzf_deque_new(&dq, sizeof(int));
+    assert(dzf_deque_capacity(&dq) == DZF_DEQUE_ALLOC_SIZE);
+
+    /* -9 .. -1 at the head, 0 .. 9 at the tail, growing across the wrap */
+    for (i = 0; i < 10; i++) {
+        dzf_deque_push_tail(&dq, i);
+        if (i)
+            dzf_deque_push_head(&dq, -i);
+    }
+    assert(dzf_deque_size(&dq) == 19);
+    assert(dzf_deque_capacity(&dq) == 32);
+    for (i = 0; i < 19; i++)
+        assert(dzf_deque_get(&dq, (size_t)i) == i - 9);
+    assert(dzf_deque_front(&dq) == -9);
+    assert(dzf_deque_back(&dq) == 9);
+
+    dzf_deque_set(&dq, 9, 100);
+    assert(dzf_deque_get(&dq, 9) == 100);
+
+    dzf_deque_foreach(&dq, deque_int_print, NULL);
+    putchar('\n');
+
+    assert(dzf_deque_pop_head(&dq) == -9);
+    assert(dzf_deque_pop_tail(&dq) == 9);
+    assert(dzf_deque_pop_tail(&dq) == 8);
+    assert(dzf_deque_size(&dq) == 16);
+
+    dzf_deque_clear(&dq);
+    assert(dzf_deque_is_empty(&dq) == TRUE);
+    dzf_deque_push_head(&dq, 1);
+    assert(dzf_deque_pop_tail(&dq) == 1);
+
+    dzf_deque_data_free(&dq);
+    assert(dq.data == NULL);
+}
+
+
+/* Test for the maximum of each window, a classic deque use */
+static void
+deque_sliding_window(void)
+{
+    typedef dzf_deque_t(size_t) deque_idx_t;
+    static const int in[] = { 1, 3, -1, -3, 5, 3, 6, 7 };
+    static const int expected[] = { 3, 3, 5, 5, 6, 7 };
+    const size_t k = 3;
+    deque_idx_t dq;
+    size_t i;
+
+    dzf_deque_new(&dq, sizeof(size_t));
+    for (i = 0; i < dzf_array_size(in); i++) {
+        if (!dzf_deque_is_empty(&dq) && dzf_deque_front(&dq) + k <= i)
+            (void)dzf_deque_pop_head(&dq);
+        while (!dzf_deque_is_empty(&dq) && in[dzf_deque_back(&dq)] <= in[i])
+            (void)dzf_deque_pop_tail(&dq);
+        dzf_deque_push_tail(&dq, i);
+        if (i + 1 >= k)
+            assert(in[dzf_deque_front(&dq)] == expected[i + 1 - k]);
+    }
+
+    dzf_deque_data_free(&dq);
+}
@@ -0,0 +1,128 @@
+/* test_hmap.c
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "test.h"
+
+#include <dzf/dzf-hmap.h>
+
+static void hmap_int_type(void);
+static void hmap_str_type(void);
+
+void
+hmap_main(void)
+{
+    border("HMAP INT TYPE");
+    hmap_int_type();
+
+    border("HMAP STRING TYPE");
+    hmap_str_type();
+}
+
+
+static void
+hmap_sum_values(const int *key, long *value, long *sum)
+{
+    (void)key;
+    *sum += *value;
+}
+
+
+/* Test for int keys, with growth and backward-shift removal */
+static void
+hmap_int_type(void)
+{
+    typedef dzf_hmap_t(int, long) hmap_int_long_t;
+    hmap_int_long_t map;
+    long sum = 0;
+    long *v;
+    int i;
+
+    dzf_hmap_new(&map, NULL, NULL);
+    assert(dzf_hmap_capacity(&map) == DZF_HMAP_ALLOC_SIZE);
+    assert(dzf_hmap_is_empty(&map) == TRUE);
+    assert(dzf_hmap_get(&map, 1) == NULL);
+
+    for (i = 0; i < 1000; i++)
+        assert(dzf_hmap_put(&map, i * 16, (long)i) == TRUE);
+    assert(dzf_hmap_size(&map) == 1000);
+    assert(dzf_hmap_capacity(&map) == 2048);
+
+    /* overwrite */
+    assert(dzf_hmap_put(&map, 32, 200L) == FALSE);
+    v = dzf_hmap_get(&map, 32);
+    assert(v != NULL && *v == 200);
+    *v = 2;
+
+    for (i = 0; i < 1000; i++) {
+        v = dzf_hmap_get(&map, i * 16);
+        assert(v != NULL && *v == i);
+    }
+    assert(dzf_hmap_contains(&map, 8) == FALSE);
+
+    /* remove every other key, the rest must still be reachable */
+    for (i = 0; i < 1000; i += 2)
+        assert(dzf_hmap_remove(&map, i * 16) == TRUE);
+    assert(dzf_hmap_remove(&map, 0) == FALSE);
+    assert(dzf_hmap_size(&map) == 500);
+    for (i = 0; i < 1000; i++)
+        assert(dzf_hmap_contains(&map, i * 16) == (i % 2 ? TRUE : FALSE));
+
+    dzf_hmap_foreach(&map, hmap_sum_values, &sum);
+    assert(sum == 500L * 500L);
+
+    dzf_hmap_clear(&map);
+    assert(dzf_hmap_size(&map) == 0);
+    assert(dzf_hmap_contains(&map, 16) == FALSE);
+
+    dzf_hmap_data_free(&map);
+    assert(map.data == NULL);
+}
+
+
+/* Test for string keys */
+static void
+hmap_str_type(void)
+{
+    typedef dzf_hmap_t(char *, int) hmap_str_int_t;
+    hmap_str_int_t map;
+    char key[] = "apple";
+    dzf_hash_fn hash = dzf_hmap_hash_str;
+    dzf_eq_fn eq = dzf_hmap_eq_str;
+    int *v;
+
+    dzf_hmap_init(&map, 4, hash, eq);
+    dzf_hmap_put(&map, "apple", 1);
+    dzf_hmap_put(&map, "banana", 2);
+    dzf_hmap_put(&map, "cherry", 3);
+
+    /* looked up by contents, not by address */
+    v = dzf_hmap_get(&map, key);
+    assert(v != NULL && *v == 1);
+    assert(dzf_hmap_remove(&map, "banana") == TRUE);
+    assert(dzf_hmap_get(&map, "banana") == NULL);
+    assert(*dzf_hmap_get(&map, "cherry") == 3);
+    printf("Size of hmap: %zu\n", dzf_hmap_size(&map));
+
+    dzf_hmap_data_free(&map);
+}
@@ -0,0 +1,116 @@
+/* test_hset.c
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "test.h"
+
+#include <stdint.h>
+
+#include <dzf/dzf-hset.h>
+
+static void hset_u64_type(void);
+static void hset_churn(void);
+
+void
+hset_main(void)
+{
+    border("HSET U64 TYPE");
+    hset_u64_type();
+
+    border("HSET CHURN");
+    hset_churn();
+}
+
+
+static void
+hset_sum(const uint64_t *elem, uint64_t *sum)
+{
+    *sum += *elem;
+}
+
+
+/* Test for uint64_t type */
+static void
+hset_u64_type(void)
+{
+    typedef dzf_hset_t(uint64_t) hset_u64_t;
+    hset_u64_t set;
+    uint64_t sum = 0;
+    uint64_t i;
+
+    dzf_hset_new(&set, sizeof(uint64_t), NULL, NULL);
+    assert(dzf_hset_capacity(&set) == DZF_HSET_ALLOC_SIZE);
+    assert(dzf_hset_contains(&set, 0) == FALSE);
+
+    for (i = 1; i <= 1000; i++)
+        assert(dzf_hset_insert(&set, i) == TRUE);
+    assert(dzf_hset_insert(&set, 500) == FALSE);
+    assert(dzf_hset_size(&set) == 1000);
+    assert(dzf_hset_capacity(&set) == 2048);
+
+    for (i = 1; i <= 1000; i++)
+        assert(dzf_hset_contains(&set, i) == TRUE);
+    assert(dzf_hset_contains(&set, 1001) == FALSE);
+
+    dzf_hset_foreach(&set, hset_sum, &sum);
+    assert(sum == 1000 * 1001 / 2);
+
+    for (i = 1; i <= 1000; i += 2)
+        assert(dzf_hset_remove(&set, i) == TRUE);
+    assert(dzf_hset_remove(&set, 1) == FALSE);
+    assert(dzf_hset_size(&set) == 500);
+    for (i = 1; i <= 1000; i++)
+        assert(dzf_hset_contains(&set, i) == (i % 2 ? FALSE : TRUE));
+
+    dzf_hset_clear(&set);
+    assert(dzf_hset_is_empty(&set) == TRUE);
+    assert(dzf_hset_contains(&set, 2) == FALSE);
+
+    dzf_hset_data_free(&set);
+    assert(set.data == NULL);
+}
+
+
+/* Test for tombstones being purged without growing */
+static void
+hset_churn(void)
+{
+    typedef dzf_hset_t(int) hset_int_t;
+    hset_int_t set;
+    int i;
+
+    dzf_hset_init(&set, sizeof(int), 64, NULL, NULL);
+
+    /* keep 20 elems alive while inserting and removing many more */
+    for (i = 0; i < 10000; i++) {
+        dzf_hset_insert(&set, i);
+        if (i >= 20)
+            assert(dzf_hset_remove(&set, i - 20) == TRUE);
+    }
+    assert(dzf_hset_size(&set) == 20);
+    assert(dzf_hset_capacity(&set) == 64);
+    for (i = 0; i < 10000; i++)
+        assert(dzf_hset_contains(&set, i) == (i >= 9980 ? TRUE : FALSE));
+
+    dzf_hset_data_free(&set);
+}
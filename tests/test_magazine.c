@@ -0,0 +1,143 @@
+/* test_magazine.c
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "test.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include <dzf/dzf-cstack.h>
+#include <dzf/dzf-magazine.h>
+
+typedef dzf_mag_cache_t(long) mag_cache_long_t;
+
+static void magazine_long_type(void);
+static void magazine_threads(void);
+
+void
+magazine_main(void)
+{
+    border("MAGAZINE");
+    magazine_long_type();
+
+    border("MAGAZINE THREADS");
+    magazine_threads();
+}
+
+
+/* Test for long type in a single thread */
+static void
+magazine_long_type(void)
+{
+    dzf_depot_t depot;
+    mag_cache_long_t cache, other;
+    long i, val;
+
+    dzf_depot_init(&depot, sizeof(long), 4);
+    dzf_mag_cache_init(&cache, &depot);
+    assert(dzf_mag_cache_try_pop(&cache, &val) == FALSE);
+
+    /* 8 stay in the cache, the rest reach the depot */
+    for (i = 0; i < 20; i++)
+        dzf_mag_cache_push(&cache, i);
+    assert(dzf_cstack_size(&depot.full) == 3);
+
+    /* another cache sees the ones in the depot */
+    dzf_mag_cache_init(&other, &depot);
+    for (i = 0; dzf_mag_cache_try_pop(&other, &val); i++)
+        ;
+    assert(i == 12);
+    dzf_mag_cache_flush(&other);
+
+    for (i = 0; dzf_mag_cache_try_pop(&cache, &val); i++)
+        ;
+    assert(i == 8);
+    dzf_mag_cache_flush(&cache);
+    assert(dzf_cstack_size(&depot.full) == 0);
+
+    dzf_depot_data_free(&depot);
+}
+
+
+/* Test for threads recycling values through their caches */
+#define MAGAZINE_NR_THREADS 4
+#define MAGAZINE_NR_ITEMS 100000L
+
+static dzf_depot_t m_depot;
+static atomic_uchar m_taken[MAGAZINE_NR_ITEMS];   /* times each value is taken */
+
+static void *
+magazine_worker(void *arg)
+{
+    mag_cache_long_t cache;
+    long i, val;
+
+    (void)arg;
+
+    dzf_mag_cache_init(&cache, &m_depot);
+
+    /* take values that others pushed and push them again */
+    for (i = 0; i < MAGAZINE_NR_ITEMS; i++)
+        if (dzf_mag_cache_try_pop(&cache, &val))
+            dzf_mag_cache_push(&cache, val);
+
+    /* then take home whatever this cache can reach */
+    while (dzf_mag_cache_try_pop(&cache, &val)) {
+        assert(val >= 0 && val < MAGAZINE_NR_ITEMS);
+        atomic_fetch_add_explicit(&m_taken[val], 1, memory_order_relaxed);
+    }
+
+    dzf_mag_cache_flush(&cache);
+
+    return NULL;
+}
+
+static void
+magazine_threads(void)
+{
+    pthread_t workers[MAGAZINE_NR_THREADS];
+    long n = MAGAZINE_NR_ITEMS;
+    mag_cache_long_t cache;
+    long i;
+
+    dzf_depot_init(&m_depot, sizeof(long), 0);
+    dzf_mag_cache_init(&cache, &m_depot);
+    for (i = 0; i < n; i++) {
+        atomic_init(&m_taken[i], 0);
+        dzf_mag_cache_push(&cache, i);
+    }
+    dzf_mag_cache_flush(&cache);
+
+    for (i = 0; i < MAGAZINE_NR_THREADS; i++)
+        pthread_create(&workers[i], NULL, magazine_worker, NULL);
+    for (i = 0; i < MAGAZINE_NR_THREADS; i++)
+        pthread_join(workers[i], NULL);
+
+    /* every value in [0, n) has been taken home exactly once */
+    for (i = 0; i < n; i++)
+        assert(atomic_load(&m_taken[i]) == 1);
+    printf("%ld items have been recycled.\n", n);
+
+    dzf_depot_data_free(&m_depot);
+}
@@ -0,0 +1,151 @@
+/* test_mpmc_queue.c
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "test.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include <dzf/dzf-mpmc-queue.h>
+
+typedef dzf_mpmc_queue_t(long) mpmc_long_t;
+
+static void mpmc_queue_long_type(void);
+static void mpmc_queue_threads(void);
+
+void
+mpmc_queue_main(void)
+{
+    border("MPMC QUEUE");
+    mpmc_queue_long_type();
+
+    border("MPMC QUEUE THREADS");
+    mpmc_queue_threads();
+}
+
+
+/* Test for long type in a single thread */
+static void
+mpmc_queue_long_type(void)
+{
+    mpmc_long_t queue;
+    long i, val;
+
+    dzf_mpmc_queue_new(&queue, sizeof(long));
+    assert(dzf_mpmc_queue_capacity(&queue) == DZF_MPMC_QUEUE_ALLOC_SIZE);
+    assert(dzf_mpmc_queue_elem_size(&queue) == sizeof(long));
+    assert(dzf_mpmc_queue_try_deq(&queue, &val) == FALSE);
+
+    /* go around the ring a few laps */
+    for (i = 0; i < 3 * DZF_MPMC_QUEUE_ALLOC_SIZE; i++) {
+        assert(dzf_mpmc_queue_try_enq(&queue, &i) == TRUE);
+        assert(dzf_mpmc_queue_try_deq(&queue, &val) == TRUE);
+        assert(val == i);
+    }
+
+    for (i = 0; i < DZF_MPMC_QUEUE_ALLOC_SIZE; i++)
+        assert(dzf_mpmc_queue_try_enq(&queue, &i) == TRUE);
+    assert(dzf_mpmc_queue_try_enq(&queue, &i) == FALSE);
+    assert(dzf_mpmc_queue_size(&queue) == DZF_MPMC_QUEUE_ALLOC_SIZE);
+
+    for (i = 0; i < DZF_MPMC_QUEUE_ALLOC_SIZE; i++) {
+        assert(dzf_mpmc_queue_try_deq(&queue, &val) == TRUE);
+        assert(val == i);
+    }
+    assert(dzf_mpmc_queue_try_deq(&queue, &val) == FALSE);
+    assert(dzf_mpmc_queue_size(&queue) == 0);
+
+    dzf_mpmc_queue_data_free(&queue);
+}
+
+
+/* Test for producers and consumers threads */
+#define MPMC_QUEUE_NR_THREADS 4
+#define MPMC_QUEUE_NR_ITEMS 200000L
+
+static mpmc_long_t mpmc_queue;
+static atomic_uchar mpmc_taken[MPMC_QUEUE_NR_THREADS * MPMC_QUEUE_NR_ITEMS];
+
+static void *
+mpmc_queue_producer(void *arg)
+{
+    long base = (long)(intptr_t)arg * MPMC_QUEUE_NR_ITEMS;
+    long i, val;
+
+    for (i = 0; i < MPMC_QUEUE_NR_ITEMS; i++) {
+        val = base + i;
+        while (!dzf_mpmc_queue_try_enq(&mpmc_queue, &val))
+            ; /* spin while full */
+    }
+
+    return NULL;
+}
+
+static void *
+mpmc_queue_consumer(void *arg)
+{
+    long i, val;
+
+    for (i = 0; i < MPMC_QUEUE_NR_ITEMS; i++) {
+        while (!dzf_mpmc_queue_try_deq(&mpmc_queue, &val))
+            ; /* spin while empty */
+        assert(val >= 0 && val < MPMC_QUEUE_NR_THREADS * MPMC_QUEUE_NR_ITEMS);
+        atomic_fetch_add_explicit(&mpmc_taken[val], 1, memory_order_relaxed);
+    }
+
+    return NULL;
+}
+
+static void
+mpmc_queue_threads(void)
+{
+    pthread_t producers[MPMC_QUEUE_NR_THREADS];
+    pthread_t consumers[MPMC_QUEUE_NR_THREADS];
+    long n = MPMC_QUEUE_NR_THREADS * MPMC_QUEUE_NR_ITEMS;
+    long v;
+    int i;
+
+    dzf_mpmc_queue_new(&mpmc_queue, sizeof(long));
+    for (v = 0; v < n; v++)
+        atomic_init(&mpmc_taken[v], 0);
+
+    for (i = 0; i < MPMC_QUEUE_NR_THREADS; i++) {
+        pthread_create(&consumers[i], NULL, mpmc_queue_consumer, NULL);
+        pthread_create(&producers[i], NULL, mpmc_queue_producer,
+                       (void *)(intptr_t)i);
+    }
+
+    for (i = 0; i < MPMC_QUEUE_NR_THREADS; i++) {
+        pthread_join(producers[i], NULL);
+        pthread_join(consumers[i], NULL);
+    }
+
+    /* every value in [0, n) has been dequeued exactly once */
+    for (v = 0; v < n; v++)
+        assert(atomic_load(&mpmc_taken[v]) == 1);
+    assert(dzf_mpmc_queue_size(&mpmc_queue) == 0);
+    printf("%ld items have been handed over.\n", n);
+
+    dzf_mpmc_queue_data_free(&mpmc_queue);
+}
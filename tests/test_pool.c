@@ -0,0 +1,86 @@
+/* test_pool.c
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "test.h"
+
+#include <stdint.h>
+
+#include <dzf/dzf-pool.h>
+
+struct node {
+    struct node *next;
+    long value;
+    char tag[5];
+};
+
+static void pool_node_type(void);
+
+void
+pool_main(void)
+{
+    border("POOL NODE TYPE");
+    pool_node_type();
+}
+
+
+/* Test for a struct type */
+static void
+pool_node_type(void)
+{
+    typedef dzf_pool_t(struct node) pool_node_t;
+    pool_node_t pool;
+    struct node *nodes[100];
+    struct node *n;
+    int i;
+
+    dzf_pool_init(&pool, sizeof(struct node), 32);
+    assert(dzf_pool_size(&pool) == 0);
+    assert(dzf_pool_capacity(&pool) == 0);
+
+    for (i = 0; i < 100; i++) {
+        nodes[i] = dzf_pool_alloc(&pool);
+        nodes[i]->value = i;
+        assert(((uintptr_t)nodes[i] % _Alignof(struct node)) == 0);
+    }
+    assert(((uintptr_t)nodes[0] % DZF_CACHELINE_SIZE) == 0);
+    assert(dzf_pool_size(&pool) == 100);
+    assert(dzf_pool_capacity(&pool) == 128);   /* grown by whole slabs */
+
+    for (i = 0; i < 100; i++)
+        assert(nodes[i]->value == i);
+
+    /* the latest one freed is reused first */
+    dzf_pool_release(&pool, nodes[10]);
+    dzf_pool_release(&pool, nodes[20]);
+    assert(dzf_pool_size(&pool) == 98);
+
+    n = dzf_pool_alloc(&pool);
+    assert(n == nodes[20]);
+    n = dzf_pool_alloc(&pool);
+    assert(n == nodes[10]);
+    assert(dzf_pool_capacity(&pool) == 128);
+
+    dzf_pool_data_free(&pool);
+    assert(dzf_pool_size(&pool) == 0);
+}
@@ -0,0 +1,117 @@
+/* test_pq.c
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "test.h"
+
+#include <stdlib.h>
+
+#include <dzf/dzf-vector.h>
+#include <dzf/dzf-pq.h>
+
+static void pq_int_type(void);
+static void pq_from_vec(void);
+
+void
+pq_main(void)
+{
+    border("PQ INT TYPE");
+    pq_int_type();
+
+    border("PQ FROM VECTOR");
+    pq_from_vec();
+}
+
+
+static int
+cmp_int(const void *a, const void *b)
+{
+    int x = *(const int *)a, y = *(const int *)b;
+
+    return (x > y) - (x < y);
+}
+
+
+/* Test for int type, for each arity */
+static void
+pq_int_type(void)
+{
+    typedef dzf_pq_t(int) pq_int_t;
+    pq_int_t pq;
+    size_t arity;
+    int i, prev;
+
+    for (arity = 2; arity <= 8; arity++) {
+        dzf_pq_new(&pq, sizeof(int), cmp_int);
+        assert(dzf_pq_get_arity(&pq) == DZF_PQ_ARITY);
+        dzf_pq_set_arity(&pq, arity);
+        assert(dzf_pq_is_empty(&pq) == TRUE);
+
+        srand(7);
+        for (i = 0; i < 1000; i++)
+            dzf_pq_push(&pq, rand() % 500);
+        dzf_pq_push(&pq, -1);
+        assert(dzf_pq_size(&pq) == 1001);
+        assert(dzf_pq_peek(&pq) == -1);
+
+        prev = dzf_pq_pop(&pq);
+        while (!dzf_pq_is_empty(&pq)) {
+            i = dzf_pq_pop(&pq);
+            assert(prev <= i);
+            prev = i;
+        }
+
+        dzf_pq_data_free(&pq);
+    }
+}
+
+
+/* Test for heapifying the elems of a vector */
+static void
+pq_from_vec(void)
+{
+    typedef dzf_vec_t(int) vec_int_t;
+    typedef dzf_pq_t(int) pq_int_t;
+    vec_int_t vec;
+    pq_int_t pq;
+    int i;
+
+    dzf_vec_new(&vec, sizeof(int));
+    for (i = 100; i > 0; i--)
+        dzf_vec_add_tail(&vec, i);
+
+    dzf_pq_init_from_vec(&pq, &vec, cmp_int);
+    assert(vec.data == NULL);
+    assert(dzf_pq_size(&pq) == 100);
+
+    /* rearrange into a binary heap */
+    dzf_pq_set_arity(&pq, 2);
+    for (i = 1; i <= 50; i++)
+        assert(dzf_pq_pop(&pq) == i);
+    dzf_pq_push(&pq, 0);
+    assert(dzf_pq_pop(&pq) == 0);
+    assert(dzf_pq_pop(&pq) == 51);
+    printf("Size of pq: %zu\n", dzf_pq_size(&pq));
+
+    dzf_pq_data_free(&pq);
+}
@@ -27,6 +27,10 @@
 #include <dzf/dzf-queue.h>
 
 static void queue_int_type(void);
+static void queue_growable_type(void);
+static void queue_batch(void);
+static void queue_borrowed(void);
+static void queue_aligned(void);
 static void queue_func_ptr_type(void);
 
 void
@@ -35,6 +39,18 @@ queue_main(void)
     border("QUEUE");
     queue_int_type();
 
+    border("QUEUE GROWABLE");
+    queue_growable_type();
+
+    border("QUEUE BATCH");
+    queue_batch();
+
+    border("QUEUE BORROWED");
+    queue_borrowed();
+
+    border("QUEUE ALIGNED");
+    queue_aligned();
+
     border("FUNCTION POINTER");
     queue_func_ptr_type();
 }
@@ -64,7 +80,8 @@ queue_int_type(void)
     dzf_queue_enq(&queue, 4);
     dzf_queue_enq(&queue, 100);
     dzf_queue_enq(&queue, 200);
-    assert(dzf_queue_rear(&queue) == 2);
+    assert(dzf_queue_size(&queue) == 3);
+    assert(dzf_queue_rear(&queue) == (100 + 2) % DZF_QUEUE_ALLOC_SIZE);
 
     assert(dzf_queue_deq(&queue) == 4);
     assert(dzf_queue_deq(&queue) == 100);
@@ -76,6 +93,178 @@ queue_int_type(void)
     }
 
     dzf_queue_data_free(&queue);
+
+    /* capacity is rounded up to a power of two */
+    dzf_queue_init(&queue, sizeof(int), 100);
+    assert(dzf_queue_capacity(&queue) == 128);
+    dzf_queue_data_free(&queue);
+}
+
+
+/* Test for growable type */
+static void
+queue_growable_type(void)
+{
+    typedef dzf_queue_t(int) queue_int_t;
+    queue_int_t queue;
+    int i;
+
+    dzf_queue_new(&queue, sizeof(int));
+    assert(dzf_queue_is_growable(&queue) == FALSE);
+    dzf_queue_set_growable(&queue, TRUE);
+    assert(dzf_queue_is_growable(&queue) == TRUE);
+
+    /* wrap the ring around before growing */
+    for (i = 0; i < 10; i++)
+        dzf_queue_enq(&queue, -1);
+    for (i = 0; i < 8; i++)
+        (void)dzf_queue_deq(&queue);
+
+    for (i = 0; i < 100; i++)
+        dzf_queue_enq(&queue, i);
+    assert(dzf_queue_capacity(&queue) == 128);
+
+    assert(dzf_queue_deq(&queue) == -1);
+    assert(dzf_queue_deq(&queue) == -1);
+    for (i = 0; i < 100; i++)
+        assert(dzf_queue_deq(&queue) == i);
+    assert(dzf_queue_is_empty(&queue) == TRUE);
+
+    /* the other segment is the shorter one */
+    for (i = 0; i < 120; i++)
+        dzf_queue_enq(&queue, -1);
+    for (i = 0; i < 118; i++)
+        (void)dzf_queue_deq(&queue);
+
+    for (i = 0; i < 200; i++)
+        dzf_queue_enq(&queue, i);
+    assert(dzf_queue_capacity(&queue) == 256);
+
+    assert(dzf_queue_deq(&queue) == -1);
+    assert(dzf_queue_deq(&queue) == -1);
+    for (i = 0; i < 200; i++)
+        assert(dzf_queue_deq(&queue) == i);
+
+    dzf_queue_data_free(&queue);
+    assert(dzf_queue_is_growable(&queue) == FALSE);
+}
+
+
+/* Test for batch enqueue/dequeue */
+static void
+queue_batch(void)
+{
+    typedef dzf_queue_t(int) queue_int_t;
+    queue_int_t queue;
+    int src[40], dst[40];
+    int i;
+
+    for (i = 0; i < 40; i++)
+        src[i] = i;
+
+    dzf_queue_new(&queue, sizeof(int));
+
+    /* move the head close to the end, then wrap around in a batch */
+    dzf_queue_enq_n(&queue, src, 12);
+    assert(dzf_queue_deq_n(&queue, dst, 12) == 12);
+    dzf_queue_enq_n(&queue, src, 10);
+    assert(dzf_queue_size(&queue) == 10);
+    assert(dzf_queue_rear(&queue) == 5);
+
+    assert(dzf_queue_deq(&queue) == 0);
+    assert(dzf_queue_deq_n(&queue, dst, 40) == 9);
+    for (i = 0; i < 9; i++)
+        assert(dst[i] == i + 1);
+    assert(dzf_queue_is_empty(&queue) == TRUE);
+    assert(dzf_queue_deq_n(&queue, dst, 1) == 0);
+
+    /* grow once for the whole batch */
+    dzf_queue_set_growable(&queue, TRUE);
+    dzf_queue_enq(&queue, -1);
+    dzf_queue_enq_n(&queue, src, 40);
+    assert(dzf_queue_capacity(&queue) == 64);
+    assert(dzf_queue_deq(&queue) == -1);
+    assert(dzf_queue_deq_n(&queue, dst, 40) == 40);
+    assert(memcmp(src, dst, sizeof(src)) == 0);
+
+    /* empty batches never touch the buffers */
+    dzf_queue_enq_n(&queue, NULL, 0);
+    assert(dzf_queue_size(&queue) == 0);
+    assert(dzf_queue_deq_n(&queue, NULL, 0) == 0);
+
+    dzf_queue_data_free(&queue);
+}
+
+
+/* Test for caller-provided buckets */
+static void
+queue_borrowed(void)
+{
+    typedef dzf_queue_t(int) queue_int_t;
+    queue_int_t queue;
+    int buf[10];
+    int i;
+
+    /* only 8 of 10 buckets are used */
+    dzf_queue_init_with_buffer(&queue, sizeof(int), buf, dzf_array_size(buf));
+    assert(dzf_queue_capacity(&queue) == 8);
+    assert(queue.data == buf);
+
+    for (i = 0; i < 8; i++)
+        dzf_queue_enq(&queue, i);
+    assert(dzf_queue_is_full(&queue) == TRUE);
+    assert(buf[7] == 7);
+
+    /* wrap around, then copy out to the heap on growth */
+    for (i = 0; i < 5; i++)
+        assert(dzf_queue_deq(&queue) == i);
+    for (i = 8; i < 13; i++)
+        dzf_queue_enq(&queue, i);
+    dzf_queue_set_growable(&queue, TRUE);
+    dzf_queue_enq(&queue, 13);
+    assert(queue.data != buf);
+    assert(dzf_queue_capacity(&queue) == 16);
+    assert(dzf_queue_size(&queue) == 9);
+    for (i = 5; i < 14; i++)
+        assert(dzf_queue_deq(&queue) == i);
+
+    dzf_queue_data_free(&queue);
+
+    /* never outgrown, nothing to free */
+    dzf_queue_init_with_buffer(&queue, sizeof(int), buf, 4);
+    dzf_queue_enq(&queue, 1);
+    dzf_queue_data_free(&queue);
+    assert(queue.data == NULL);
+}
+
+
+/* Test for aligned buckets */
+static void
+queue_aligned(void)
+{
+    typedef dzf_queue_t(int) queue_int_t;
+    queue_int_t queue;
+    int i;
+
+    dzf_queue_init_aligned(&queue, sizeof(int), 16, DZF_CACHELINE_SIZE);
+    dzf_queue_set_growable(&queue, TRUE);
+    assert((uintptr_t)queue.data % DZF_CACHELINE_SIZE == 0);
+
+    /* wrap the ring around before growing */
+    for (i = 0; i < 10; i++)
+        dzf_queue_enq(&queue, -1);
+    for (i = 0; i < 10; i++)
+        (void)dzf_queue_deq(&queue);
+
+    for (i = 0; i < 100; i++)
+        dzf_queue_enq(&queue, i);
+    assert(dzf_queue_capacity(&queue) == 128);
+    assert((uintptr_t)queue.data % DZF_CACHELINE_SIZE == 0);
+
+    for (i = 0; i < 100; i++)
+        assert(dzf_queue_deq(&queue) == i);
+
+    dzf_queue_data_free(&queue);
 }
 
 
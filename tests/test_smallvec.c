@@ -0,0 +1,74 @@
+/* test_smallvec.c
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "test.h"
+
+#include <dzf/dzf-smallvec.h>
+
+static void smallvec_int_type(void);
+
+void
+smallvec_main(void)
+{
+    border("SMALLVEC INT TYPE");
+    smallvec_int_type();
+}
+
+
+/* Test for int type */
+static void
+smallvec_int_type(void)
+{
+    typedef dzf_smallvec_t(int, 4) smallvec_int_t;
+    smallvec_int_t vec;
+    int i;
+
+    dzf_smallvec_new(&vec);
+    assert(dzf_vec_get_alloc_size(&vec) == 4);
+    assert(dzf_smallvec_is_inline(&vec));
+
+    for (i = 0; i < 4; i++)
+        dzf_vec_add_tail(&vec, i);
+    assert(dzf_smallvec_is_inline(&vec));
+    dzf_vec_rmv_head(&vec);
+    dzf_ved_add_head(&vec, 0);
+    assert(dzf_smallvec_is_inline(&vec));
+
+    /* spill to the heap */
+    for (; i < 20; i++)
+        dzf_vec_add_tail(&vec, i);
+    assert(!dzf_smallvec_is_inline(&vec));
+    assert(dzf_vec_get_length(&vec) == 20);
+    assert(dzf_vec_get_alloc_size(&vec) == 32);
+    for (i = 0; i < 20; i++)
+        assert(dzf_vec_get_value(&vec, i) == i);
+
+    dzf_vec_data_free(&vec);
+
+    /* never spilled, nothing to free */
+    dzf_smallvec_new(&vec);
+    dzf_vec_add_tail(&vec, 1);
+    assert(dzf_vec_shrink_to_fit(&vec) == 4);
+    dzf_vec_data_free(&vec);
+}
@@ -0,0 +1,178 @@
+/* test_sort.c
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "test.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <dzf/dzf-vector.h>
+#include <dzf/dzf-sort.h>
+
+struct item {
+    int key;
+    int seq;
+};
+
+#define item_less(a, b) ((a).key < (b).key)
+
+DZF_SORT_DEFINE(int, int, DZF_SORT_LESS)
+DZF_SORT_DEFINE(item, struct item, item_less)
+
+static void sort_int_type(void);
+static void sort_stable(void);
+static void sort_radix(void);
+
+void
+sort_main(void)
+{
+    border("SORT INT TYPE");
+    sort_int_type();
+
+    border("SORT STABLE");
+    sort_stable();
+
+    border("SORT RADIX");
+    sort_radix();
+}
+
+
+static int
+cmp_int(const void *a, const void *b)
+{
+    int x = *(const int *)a, y = *(const int *)b;
+
+    return (x > y) - (x < y);
+}
+
+
+/* Test for introsort against qsort(3), on random, few-unique and sorted */
+static void
+sort_int_type(void)
+{
+    typedef dzf_vec_t(int) vec_int_t;
+    vec_int_t vec;
+    int *expect;
+    size_t n, i;
+    int round;
+
+    srand(11);
+    for (round = 0; round < 4; round++) {
+        n = (round == 0) ? 10 : 20000;
+        dzf_vec_new(&vec, sizeof(int));
+        expect = malloc(n * sizeof(int));
+
+        for (i = 0; i < n; i++) {
+            switch (round) {
+            case 2:  expect[i] = rand() % 4;          break;
+            case 3:  expect[i] = (int)(n - i);        break;
+            default: expect[i] = rand() - RAND_MAX / 2;
+            }
+            dzf_vec_add_tail(&vec, expect[i]);
+        }
+
+        dzf_sort_int(&vec);
+        qsort(expect, n, sizeof(int), cmp_int);
+        for (i = 0; i < n; i++)
+            assert(dzf_vec_get_value(&vec, i) == expect[i]);
+
+        free(expect);
+        dzf_vec_data_free(&vec);
+    }
+}
+
+
+/* Test for stable merge sort, equal keys keep their order */
+static void
+sort_stable(void)
+{
+    typedef dzf_vec_t(struct item) vec_item_t;
+    vec_item_t vec;
+    struct item it;
+    size_t i;
+
+    dzf_vec_new(&vec, sizeof(struct item));
+    dzf_stable_sort_item(&vec);
+    assert(dzf_vec_get_length(&vec) == 0);
+
+    srand(13);
+    for (i = 0; i < 5000; i++) {
+        it.key = rand() % 100;
+        it.seq = (int)i;
+        dzf_vec_add_tail(&vec, it);
+    }
+
+    dzf_stable_sort_item(&vec);
+    for (i = 1; i < 5000; i++) {
+        struct item prev = dzf_vec_get_value(&vec, i - 1);
+        struct item cur = dzf_vec_get_value(&vec, i);
+
+        assert(prev.key <= cur.key);
+        if (prev.key == cur.key)
+            assert(prev.seq < cur.seq);
+    }
+
+    dzf_vec_data_free(&vec);
+}
+
+
+/* Test for radix sort of unsigned and signed keys */
+static void
+sort_radix(void)
+{
+    typedef dzf_vec_t(uint32_t) vec_u32_t;
+    typedef dzf_vec_t(int64_t) vec_i64_t;
+    vec_u32_t uvec;
+    vec_i64_t ivec;
+    size_t i;
+
+    srand(17);
+    dzf_vec_new(&uvec, sizeof(uint32_t));
+    dzf_vec_new(&ivec, sizeof(int64_t));
+    for (i = 0; i < 10000; i++) {
+        dzf_vec_add_tail(&uvec, (uint32_t)rand() * 2654435761u);
+        dzf_vec_add_tail(&ivec, ((int64_t)rand() - RAND_MAX / 2) * 1000003);
+    }
+    dzf_vec_add_tail(&ivec, INT64_MIN);
+    dzf_vec_add_tail(&ivec, INT64_MAX);
+
+    dzf_radix_sort(&uvec);
+    dzf_radix_sort_signed(&ivec);
+    for (i = 1; i < 10000; i++)
+        assert(dzf_vec_get_value(&uvec, i - 1) <= dzf_vec_get_value(&uvec, i));
+    for (i = 1; i < 10002; i++)
+        assert(dzf_vec_get_value(&ivec, i - 1) <= dzf_vec_get_value(&ivec, i));
+    assert(dzf_vec_get_value(&ivec, 0) == INT64_MIN);
+    assert(dzf_vec_get_value(&ivec, 10001) == INT64_MAX);
+
+    /* small values share all the upper bytes */
+    for (i = 0; i < 10000; i++)
+        dzf_vec_set_value_at(&uvec, i, (uint32_t)(10000 - i));
+    dzf_radix_sort(&uvec);
+    for (i = 0; i < 10000; i++)
+        assert(dzf_vec_get_value(&uvec, i) == i + 1);
+
+    dzf_vec_data_free(&uvec);
+    dzf_vec_data_free(&ivec);
+}
@@ -0,0 +1,117 @@
+/* test_spsc_queue.c
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "test.h"
+
+#include <pthread.h>
+
+#include <dzf/dzf-spsc-queue.h>
+
+typedef dzf_spsc_queue_t(long) spsc_long_t;
+
+static void spsc_queue_long_type(void);
+static void spsc_queue_threads(void);
+
+void
+spsc_queue_main(void)
+{
+    border("SPSC QUEUE");
+    spsc_queue_long_type();
+
+    border("SPSC QUEUE THREADS");
+    spsc_queue_threads();
+}
+
+
+/* Test for long type in a single thread */
+static void
+spsc_queue_long_type(void)
+{
+    spsc_long_t queue;
+    long i, val;
+
+    dzf_spsc_queue_init(&queue, sizeof(long), 100);
+    assert(dzf_spsc_queue_capacity(&queue) == DZF_SPSC_QUEUE_ALLOC_SIZE);
+    assert(dzf_spsc_queue_elem_size(&queue) == sizeof(long));
+    assert(dzf_spsc_queue_is_empty(&queue) == TRUE);
+    assert(dzf_spsc_queue_try_deq(&queue, &val) == FALSE);
+    dzf_spsc_queue_data_free(&queue);
+
+    dzf_spsc_queue_init(&queue, sizeof(long), 2000);
+    assert(dzf_spsc_queue_capacity(&queue) == 2048);
+
+    for (i = 0; i < 2048; i++)
+        assert(dzf_spsc_queue_try_enq(&queue, i) == TRUE);
+    assert(dzf_spsc_queue_try_enq(&queue, i) == FALSE);
+    assert(dzf_spsc_queue_size(&queue) == 2048);
+
+    for (i = 0; i < 2048; i++) {
+        assert(dzf_spsc_queue_try_deq(&queue, &val) == TRUE);
+        assert(val == i);
+    }
+    assert(dzf_spsc_queue_try_deq(&queue, &val) == FALSE);
+
+    dzf_spsc_queue_data_free(&queue);
+}
+
+
+/* Test for a producer and a consumer thread */
+#define SPSC_QUEUE_NR_ITEMS 1000000L
+
+static void *
+spsc_queue_producer(void *arg)
+{
+    spsc_long_t *queue = arg;
+    long i;
+
+    for (i = 0; i < SPSC_QUEUE_NR_ITEMS; i++) {
+        while (!dzf_spsc_queue_try_enq(queue, i))
+            ; /* spin while full */
+    }
+
+    return NULL;
+}
+
+static void
+spsc_queue_threads(void)
+{
+    spsc_long_t queue;
+    pthread_t producer;
+    long i, val;
+
+    dzf_spsc_queue_new(&queue, sizeof(long));
+    pthread_create(&producer, NULL, spsc_queue_producer, &queue);
+
+    for (i = 0; i < SPSC_QUEUE_NR_ITEMS; i++) {
+        while (!dzf_spsc_queue_try_deq(&queue, &val))
+            ; /* spin while empty */
+        assert(val == i);
+    }
+
+    pthread_join(producer, NULL);
+    assert(dzf_spsc_queue_is_empty(&queue) == TRUE);
+    printf("%ld items have been handed over.\n", i);
+
+    dzf_spsc_queue_data_free(&queue);
+}
@@ -26,6 +26,7 @@
 
 static void stack_int_type(void);
 static void stack_str_type(void);
+static void stack_borrowed(void);
 
 void
 stack_main(void)
@@ -35,6 +36,9 @@ stack_main(void)
 
     border("STACK STRING TYPE");
     stack_str_type();
+
+    border("STACK BORROWED");
+    stack_borrowed();
 }
 
 
@@ -164,7 +168,7 @@ stack_int_type(void)
 
     temp = dzf_stack_pop(&stack);
     printf("A data that popped from stack : %d\n", temp);
-    printf("Size of stack: %d\n", dzf_stack_size(&stack));
+    printf("Size of stack: %zu\n", dzf_stack_size(&stack));
 
     dzf_stack_data_free(&stack);
     assert(stack.data == NULL);
@@ -175,3 +179,30 @@ stack_int_print(const int *item, ...)
 {
     printf("%d ", *item);
 }
+
+
+/* Test for caller-provided buckets */
+static void
+stack_borrowed(void)
+{
+    typedef dzf_stack_t(int) stack_int_t;
+    stack_int_t stack;
+    int buf[4];
+    int i;
+
+    dzf_stack_init_with_buffer(&stack, sizeof(int), buf, dzf_array_size(buf));
+    for (i = 0; i < 4; i++)
+        dzf_stack_push(&stack, i);
+    assert(stack.data == buf);
+    assert(buf[3] == 3);
+
+    /* copy out to the heap on growth */
+    dzf_stack_push(&stack, 4);
+    assert(stack.data != buf);
+    assert(dzf_stack_capacity(&stack) == 8);
+    for (i = 4; i >= 0; i--)
+        assert(dzf_stack_pop(&stack) == i);
+
+    dzf_stack_data_free(&stack);
+    assert(stack.data == NULL);
+}
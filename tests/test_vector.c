@@ -32,6 +32,13 @@
 static void vector_string_type(void);
 static void vector_double_type(void);
 static void vector_user_struct_type(void);
+static void vector_growth(void);
+static void vector_shrink(void);
+static void vector_range(void);
+static void vector_unordered_remove(void);
+static void vector_aligned(void);
+static void vector_find(void);
+static void vector_find_kernels(void);
 
 void
 vector_main(void)
@@ -44,6 +51,27 @@ vector_main(void)
 
     border("VECTOR USER DEFINED STRUCT TYPE");
     vector_user_struct_type();
+
+    border("VECTOR GROWTH");
+    vector_growth();
+
+    border("VECTOR SHRINK");
+    vector_shrink();
+
+    border("VECTOR RANGE");
+    vector_range();
+
+    border("VECTOR UNORDERED REMOVE");
+    vector_unordered_remove();
+
+    border("VECTOR ALIGNED");
+    vector_aligned();
+
+    border("VECTOR FIND");
+    vector_find();
+
+    border("VECTOR FIND KERNELS");
+    vector_find_kernels();
 }
 
 
@@ -149,3 +177,323 @@ vector_user_struct_type(void)
 
     dzf_vec_data_free(&users);
 }
+
+
+// Test for growth policies and reserve.
+static void
+vector_growth(void)
+{
+    typedef dzf_vec_t(int) vec_int_t;
+    vec_int_t ivec;
+    int i;
+
+    dzf_vec_new(&ivec, sizeof(int));
+    for (i = 0; i < 9; i++)
+        dzf_vec_add_tail(&ivec, i);
+    assert(dzf_vec_get_alloc_size(&ivec) == 16);
+
+    dzf_vec_set_growth(&ivec, DZF_VEC_GROW_HALF, 0);
+    for (; i < 17; i++)
+        dzf_vec_add_tail(&ivec, i);
+    assert(dzf_vec_get_alloc_size(&ivec) == 24);
+
+    dzf_vec_set_growth(&ivec, DZF_VEC_GROW_STEP, 10);
+    for (; i < 25; i++)
+        dzf_vec_add_tail(&ivec, i);
+    assert(dzf_vec_get_alloc_size(&ivec) == 34);
+
+    dzf_vec_set_growth(&ivec, DZF_VEC_GROW_CHUNK, 20);
+    for (; i < 35; i++)
+        dzf_vec_add_tail(&ivec, i);
+    assert(dzf_vec_get_alloc_size(&ivec) == 54);
+
+    /* exact, and never shrinks */
+    assert(dzf_vec_reserve(&ivec, 100) == 100);
+    assert(dzf_vec_reserve(&ivec, 10) == 100);
+    assert(dzf_vec_get_length(&ivec) == 35);
+
+    for (i = 0; i < 35; i++)
+        assert(dzf_vec_get_value(&ivec, i) == i);
+
+    dzf_vec_data_free(&ivec);
+}
+
+
+// Test for shrink_to_fit and auto-shrink.
+static void
+vector_shrink(void)
+{
+    typedef dzf_vec_t(int) vec_int_t;
+    vec_int_t ivec;
+    int i;
+
+    dzf_vec_new_with(&ivec, sizeof(int), 100);
+    for (i = 0; i < 10; i++)
+        dzf_vec_add_tail(&ivec, i);
+    assert(dzf_vec_shrink_to_fit(&ivec) == 10);
+    assert(dzf_vec_get_value(&ivec, 9) == 9);
+
+    for (; i < 1000; i++)
+        dzf_vec_add_tail(&ivec, i);
+    assert(dzf_vec_get_alloc_size(&ivec) == 1280);
+
+    /* off by default */
+    dzf_vec_rmv_tail(&ivec);
+    assert(dzf_vec_get_alloc_size(&ivec) == 1280);
+
+    dzf_vec_set_auto_shrink(&ivec, TRUE);
+    while (dzf_vec_get_length(&ivec) >= 320)
+        dzf_vec_rmv_tail(&ivec);
+    assert(dzf_vec_get_alloc_size(&ivec) == 640);
+
+    while (dzf_vec_get_length(&ivec) > 0)
+        dzf_vec_rmv_tail(&ivec);
+    /* halved down to 10, since 5 is below the default capacity */
+    assert(dzf_vec_get_alloc_size(&ivec) == 10);
+
+    dzf_vec_data_free(&ivec);
+}
+
+
+// Test for range insert/erase and append.
+static void
+vector_range(void)
+{
+    typedef dzf_vec_t(int) vec_int_t;
+    vec_int_t ivec, full;
+    int src[20];
+    int i;
+
+    for (i = 0; i < 20; i++)
+        src[i] = 100 + i;
+
+    dzf_vec_new(&ivec, sizeof(int));
+    for (i = 0; i < 5; i++)
+        dzf_vec_add_tail(&ivec, i);
+
+    dzf_vec_insert_range(&ivec, 2, src, 20);
+    assert(dzf_vec_get_length(&ivec) == 25);
+    assert(dzf_vec_get_alloc_size(&ivec) == 32);   /* grown once */
+    assert(dzf_vec_get_value(&ivec, 1) == 1);
+    assert(dzf_vec_get_value(&ivec, 2) == 100);
+    assert(dzf_vec_get_value(&ivec, 21) == 119);
+    assert(dzf_vec_get_value(&ivec, 22) == 2);
+    assert(dzf_vec_get_value(&ivec, 24) == 4);
+
+    dzf_vec_erase_range(&ivec, 2, 20);
+    assert(dzf_vec_get_length(&ivec) == 5);
+    for (i = 0; i < 5; i++)
+        assert(dzf_vec_get_value(&ivec, i) == i);
+
+    dzf_vec_append_array(&ivec, src, 3);
+    assert(dzf_vec_get_length(&ivec) == 8);
+    assert(dzf_vec_get_value(&ivec, 7) == 102);
+
+    dzf_vec_erase_range(&ivec, 5, 3);
+    assert(dzf_vec_get_length(&ivec) == 5);
+
+    /* empty ranges never touch the source */
+    dzf_vec_insert_range(&ivec, 0, NULL, 0);
+    dzf_vec_append_array(&ivec, NULL, 0);
+    assert(dzf_vec_get_length(&ivec) == 5);
+
+    /* removing from a full vector moves only the elems after the index */
+    dzf_vec_new(&full, sizeof(int));
+    for (i = 0; i < 8; i++)
+        dzf_vec_add_tail(&full, i);
+    assert(dzf_vec_get_length(&full) == dzf_vec_get_alloc_size(&full));
+    dzf_vec_rmv_at(&full, 0);
+    assert(dzf_vec_get_length(&full) == 7);
+    for (i = 0; i < 7; i++)
+        assert(dzf_vec_get_value(&full, i) == i + 1);
+    dzf_vec_data_free(&full);
+
+    /* a single elem is shifted by its whole size */
+    dzf_vec_add_at(&ivec, 0, -1);
+    assert(dzf_vec_get_value(&ivec, 0) == -1);
+    assert(dzf_vec_get_value(&ivec, 5) == 4);
+    dzf_vec_rmv_head(&ivec);
+    assert(dzf_vec_get_value(&ivec, 4) == 4);
+
+    dzf_vec_data_free(&ivec);
+}
+
+
+// Test for swap-remove and retain_if.
+static Bool
+vector_is_multiple_of(const void *elem, void *user_data)
+{
+    return (*(const int *)elem % *(int *)user_data == 0) ? TRUE : FALSE;
+}
+
+static void
+vector_unordered_remove(void)
+{
+    typedef dzf_vec_t(int) vec_int_t;
+    vec_int_t ivec;
+    int i, three = 3;
+
+    dzf_vec_new(&ivec, sizeof(int));
+    for (i = 0; i < 10; i++)
+        dzf_vec_add_tail(&ivec, i);
+
+    dzf_vec_swap_remove_at(&ivec, 2);
+    assert(dzf_vec_get_length(&ivec) == 9);
+    assert(dzf_vec_get_value(&ivec, 2) == 9);
+    assert(dzf_vec_get_value(&ivec, 8) == 8);
+
+    dzf_vec_swap_remove_at(&ivec, 8);
+    assert(dzf_vec_get_length(&ivec) == 8);
+    assert(dzf_vec_get_value(&ivec, 7) == 7);
+
+    /* 0 1 9 3 4 5 6 7 -> 0 9 3 6 */
+    assert(dzf_vec_retain_if(&ivec, vector_is_multiple_of, &three) == 4);
+    assert(dzf_vec_get_length(&ivec) == 4);
+    assert(dzf_vec_get_value(&ivec, 0) == 0);
+    assert(dzf_vec_get_value(&ivec, 1) == 9);
+    assert(dzf_vec_get_value(&ivec, 2) == 3);
+    assert(dzf_vec_get_value(&ivec, 3) == 6);
+
+    dzf_vec_data_free(&ivec);
+}
+
+
+// Test for aligned buckets and padded headers.
+static void
+vector_aligned(void)
+{
+    typedef dzf_vec_t(int) vec_int_t;
+    dzf_cacheline_padded(vec_int_t) vecs[2];
+    int i;
+
+    assert(sizeof(vecs[0]) % DZF_CACHELINE_SIZE == 0);
+    assert((uintptr_t)&vecs[1] % DZF_CACHELINE_SIZE == 0);
+
+    dzf_vec_new_aligned(&vecs[0].value, sizeof(int), 3, DZF_CACHELINE_SIZE);
+    dzf_vec_new_aligned(&vecs[1].value, sizeof(int), 0, 1);
+    assert((uintptr_t)vecs[0].value.data % DZF_CACHELINE_SIZE == 0);
+    assert((uintptr_t)vecs[1].value.data % sizeof(void *) == 0);
+
+    for (i = 0; i < 1000; i++) {
+        dzf_vec_add_tail(&vecs[0].value, i);
+        assert((uintptr_t)vecs[0].value.data % DZF_CACHELINE_SIZE == 0);
+    }
+    for (i = 0; i < 1000; i++)
+        assert(dzf_vec_get_value(&vecs[0].value, i) == i);
+
+    dzf_vec_erase_range(&vecs[0].value, 10, 990);
+    dzf_vec_shrink_to_fit(&vecs[0].value);
+    assert((uintptr_t)vecs[0].value.data % DZF_CACHELINE_SIZE == 0);
+    for (i = 0; i < 10; i++)
+        assert(dzf_vec_get_value(&vecs[0].value, i) == i);
+
+    dzf_vec_data_free(&vecs[0].value);
+    dzf_vec_data_free(&vecs[1].value);
+}
+
+
+// Test for find, count and contains on every elem size.
+#define VECTOR_FIND_AS(T) \
+    do { \
+        dzf_vec_t(T) vec; \
+        T v; \
+        size_t i; \
+        dzf_vec_new(&vec, sizeof(T)); \
+        for (i = 0; i < 203; i++) \
+            dzf_vec_add_tail(&vec, (T)(i % 50)); \
+        v = 7; \
+        assert(dzf_vec_find(&vec, &v) == 7); \
+        assert(dzf_vec_count(&vec, &v) == 4); \
+        v = 2; /* the last one is in the scalar tail */ \
+        assert(dzf_vec_count(&vec, &v) == 5); \
+        v = 49; \
+        assert(dzf_vec_contains(&vec, &v) == TRUE); \
+        v = 50; \
+        assert(dzf_vec_find(&vec, &v) == DZF_VEC_NPOS); \
+        assert(dzf_vec_count(&vec, &v) == 0); \
+        assert(dzf_vec_contains(&vec, &v) == FALSE); \
+        dzf_vec_set_value_at(&vec, 202, (T)50); \
+        assert(dzf_vec_find(&vec, &v) == 202); \
+        dzf_vec_data_free(&vec); \
+    } while (0)
+
+static void
+vector_find(void)
+{
+    typedef struct { char c[3]; } rgb_t;
+    typedef dzf_vec_t(rgb_t) vec_rgb_t;
+    vec_rgb_t rvec;
+    rgb_t rgb;
+    int i;
+
+    VECTOR_FIND_AS(uint8_t);
+    VECTOR_FIND_AS(uint16_t);
+    VECTOR_FIND_AS(int32_t);
+    VECTOR_FIND_AS(uint64_t);
+    VECTOR_FIND_AS(float);
+    VECTOR_FIND_AS(double);
+
+    dzf_vec_new(&rvec, sizeof(rgb_t));
+    for (i = 0; i < 20; i++) {
+        rgb.c[0] = rgb.c[1] = rgb.c[2] = (char)i;
+        dzf_vec_add_tail(&rvec, rgb);
+    }
+    rgb.c[0] = rgb.c[1] = rgb.c[2] = 13;
+    assert(dzf_vec_find(&rvec, &rgb) == 13);
+    assert(dzf_vec_count(&rvec, &rgb) == 1);
+    rgb.c[2] = 0;
+    assert(dzf_vec_contains(&rvec, &rgb) == FALSE);
+    dzf_vec_data_free(&rvec);
+}
+
+
+static void
+vector_store_as(void *dst, size_t elem_size, unsigned int x)
+{
+    uint8_t u8 = (uint8_t)x;
+    uint16_t u16 = (uint16_t)x;
+    uint32_t u32 = x;
+    uint64_t u64 = x;
+
+    switch (elem_size) {
+    case 1:  memcpy(dst, &u8, 1);  break;
+    case 2:  memcpy(dst, &u16, 2); break;
+    case 4:  memcpy(dst, &u32, 4); break;
+    default: memcpy(dst, &u64, 8);
+    }
+}
+
+// Test that every scan kernel built in agrees, whichever is dispatched.
+static void
+vector_find_kernels(void)
+{
+    static const size_t sizes[] = { 1, 2, 4, 8 };
+    char data[203 * 8];
+    uint64_t v;
+    unsigned int x;
+    size_t i, k, n, es, idx, cnt;
+
+    for (k = 0; k < dzf_array_size(sizes); k++) {
+        es = sizes[k];
+        n = sizeof(data) / es;
+        for (i = 0; i < n; i++)
+            vector_store_as(data + i * es, es, (unsigned int)(i % 50));
+
+        for (x = 0; x <= 56; x += 7) {
+            vector_store_as(&v, es, x);
+            idx = __dzf_vec_scan_scalar(data, n, es, &v, FALSE);
+            cnt = __dzf_vec_scan_scalar(data, n, es, &v, TRUE);
+            assert(x >= 50 ? (idx == n && cnt == 0) : (idx == x && cnt > 0));
+#if defined(DZF_VEC_SSE2)
+            assert(__dzf_vec_scan_sse2(data, n, es, &v, FALSE) == idx);
+            assert(__dzf_vec_scan_sse2(data, n, es, &v, TRUE) == cnt);
+#endif
+#if defined(DZF_VEC_AVX2)
+            if (__builtin_cpu_supports("avx2")) {
+                assert(__dzf_vec_scan_avx2(data, n, es, &v, FALSE) == idx);
+                assert(__dzf_vec_scan_avx2(data, n, es, &v, TRUE) == cnt);
+            }
+#endif
+        }
+    }
+}
@@ -0,0 +1,147 @@
+/* test_wsdeque.c
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Leesoo Ahn <lsahn@ooseel.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+ * Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ * THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "test.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+#include <dzf/dzf-wsdeque.h>
+
+typedef dzf_wsdeque_t(long) wsdeque_long_t;
+
+static void wsdeque_long_type(void);
+static void wsdeque_threads(void);
+
+void
+wsdeque_main(void)
+{
+    border("WSDEQUE");
+    wsdeque_long_type();
+
+    border("WSDEQUE THREADS");
+    wsdeque_threads();
+}
+
+
+/* Test for long type in a single thread */
+static void
+wsdeque_long_type(void)
+{
+    wsdeque_long_t dq;
+    long i, val;
+
+    dzf_wsdeque_new(&dq, sizeof(long));
+    assert(dzf_wsdeque_capacity(&dq) == DZF_WSDEQUE_ALLOC_SIZE);
+    assert(dzf_wsdeque_pop(&dq, &val) == FALSE);
+    assert(dzf_wsdeque_steal(&dq, &val) == FALSE);
+
+    /* grow twice */
+    for (i = 0; i < 1000; i++)
+        dzf_wsdeque_push(&dq, i);
+    assert(dzf_wsdeque_capacity(&dq) == 1024);
+    assert(dzf_wsdeque_size(&dq) == 1000);
+
+    /* LIFO at the bottom, FIFO at the top */
+    assert(dzf_wsdeque_pop(&dq, &val) == TRUE && val == 999);
+    assert(dzf_wsdeque_steal(&dq, &val) == TRUE && val == 0);
+    for (i = 998; i >= 1; i--)
+        assert(dzf_wsdeque_pop(&dq, &val) == TRUE && val == i);
+    assert(dzf_wsdeque_pop(&dq, &val) == FALSE);
+    assert(dzf_wsdeque_size(&dq) == 0);
+
+    dzf_wsdeque_data_free(&dq);
+}
+
+
+/* Test for an owner racing thieves */
+#define WSDEQUE_NR_THIEVES 3
+#define WSDEQUE_NR_ITEMS 200000L
+
+static wsdeque_long_t ws_deque;
+static atomic_int ws_done;
+static atomic_uchar ws_taken[WSDEQUE_NR_ITEMS];   /* times each value is taken */
+
+static void
+wsdeque_take(long val)
+{
+    assert(val >= 0 && val < WSDEQUE_NR_ITEMS);
+    atomic_fetch_add_explicit(&ws_taken[val], 1, memory_order_relaxed);
+}
+
+static void *
+wsdeque_thief(void *arg)
+{
+    long *nr_stolen = arg;
+    long val;
+
+    while (!atomic_load(&ws_done) || dzf_wsdeque_size(&ws_deque))
+        if (dzf_wsdeque_steal(&ws_deque, &val)) {
+            wsdeque_take(val);
+            (*nr_stolen)++;
+        }
+
+    return NULL;
+}
+
+static void
+wsdeque_threads(void)
+{
+    pthread_t thieves[WSDEQUE_NR_THIEVES];
+    long stolen[WSDEQUE_NR_THIEVES] = { 0 };
+    long total = 0, n = WSDEQUE_NR_ITEMS;
+    long i, val;
+
+    /* the ring grows whenever the thieves fall behind */
+    dzf_wsdeque_new(&ws_deque, sizeof(long));
+    atomic_init(&ws_done, 0);
+    for (i = 0; i < n; i++)
+        atomic_init(&ws_taken[i], 0);
+
+    for (i = 0; i < WSDEQUE_NR_THIEVES; i++)
+        pthread_create(&thieves[i], NULL, wsdeque_thief, &stolen[i]);
+
+    /* the owner pops one out of every three it pushes */
+    for (i = 0; i < n; i++) {
+        dzf_wsdeque_push(&ws_deque, i);
+        if (i % 3 == 0 && dzf_wsdeque_pop(&ws_deque, &val))
+            wsdeque_take(val);
+    }
+    while (dzf_wsdeque_pop(&ws_deque, &val))
+        wsdeque_take(val);
+    atomic_store(&ws_done, 1);
+
+    for (i = 0; i < WSDEQUE_NR_THIEVES; i++) {
+        pthread_join(thieves[i], NULL);
+        total += stolen[i];
+    }
+
+    /* every value in [0, n) has been taken exactly once */
+    for (i = 0; i < n; i++)
+        assert(atomic_load(&ws_taken[i]) == 1);
+    printf("%ld items, %ld stolen.\n", n, total);
+
+    dzf_wsdeque_data_free(&ws_deque);
+}